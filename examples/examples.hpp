@@ -24,10 +24,12 @@
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_spline.h>
 
+#include <kariba/Span.hpp>
+
 void plot_write(size_t size, const std::vector<double>& en, const std::vector<double>& lum,
                 const std::string& path, double redshift);
-void plot_write(size_t size, const std::vector<double>& p, const std::vector<double>& g,
-                const std::vector<double>& pdens, const std::vector<double>& gdens,
+void plot_write(size_t size, kariba::Span<const double> p, kariba::Span<const double> g,
+                kariba::Span<const double> pdens, kariba::Span<const double> gdens,
                 const std::string& path);
 
 void sum_zones(size_t size_in, size_t size_out, std::vector<double>& input_en,
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <cstdarg>
 #include <fstream>
+#include <memory>
 
 #include "kariba/EBL.hpp"
 #include "kariba/constants.hpp"
@@ -8,7 +9,10 @@
 #include <kariba/Bknpower.hpp>
 #include <kariba/Compton.hpp>
 #include <kariba/Cyclosyn.hpp>
+#include <kariba/Diagnostics.hpp>
+#include <kariba/ExternalField.hpp>
 #include <kariba/Mixed.hpp>
+#include <kariba/ParticlePool.hpp>
 #include <kariba/Powerlaw.hpp>
 #include <kariba/Radiation.hpp>
 #include <kariba/ShSDisk.hpp>
@@ -72,8 +76,7 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     double z = 0.0;         // distance along the jet axis
     double tshift = 0.0;    // temperature shift from initial value due to ad. cooling
     double Urad = 0.0;      // estimate of total radiation energy density in each zone
-    double Ubb1 = 0.0,
-           Ubb2 = 0.0;    // estimate of comoving energy density of external photons
+    double Ubb1 = 0.0;      // estimate of comoving energy density of external photons
     double gmin = 0.0,
            gmax = 0.0;    // minimum/maximum Lorentz factors over which to integrate
     double syn_min = 0.0,
@@ -107,8 +110,8 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     jet_dynpars jet_dyn;       // structure with jet dynamical parameters
     jet_enpars nozzle_ener;    // structure with jet energetic parameters
     zone_pars zone;            // strucutre with parameters of each individual zone
-    com_pars agn_com;          // structure with parameters for inverse Compton fields
-                               // in AGN
+    kariba::ExternalField agn_field;    // BLR and torus photon fields for inverse Compton
+                                        // in AGN
 
     // External photon object declarations
     kariba::ShSDisk Disk;
@@ -127,6 +130,10 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     gsl_interp_accel* acc_deriv = gsl_interp_accel_alloc();
     gsl_spline* spline_deriv = gsl_spline_alloc(gsl_interp_steffen, nel);
 
+    // accelerators for the boost of the AGN photon fields
+    gsl_interp_accel* acc_agn_z = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_agn_g = gsl_interp_accel_alloc();
+
     // STEP 2: PARAMETER/FILE INITIALIZATION
     Mbh = param[0];
     Eddlum = 1.25e38 * Mbh;
@@ -206,7 +213,7 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         Disk.set_inclination(theta);
         Disk.disk_spectrum();
         if (compsw != 2 && l_disk > 0) {
-            sum_ext(50, ne, Disk.get_energy_obs(), Disk.get_nphot_obs(), tot_en, tot_lum);
+            Disk.add_spectrum(tot_en, tot_lum);
         }
         if (infosw >= 3) {
             Disk.test();
@@ -223,41 +230,41 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         BlackBody.set_lum(compar2);
         Ubb1 = compar3;
         BlackBody.bb_spectrum();
-        sum_ext(40, ne, BlackBody.get_energy_obs(), BlackBody.get_nphot_obs(), tot_en, tot_lum);
+        BlackBody.add_spectrum(tot_en, tot_lum);
     } else if (compsw == 2 && r_in < r_out) {
-        agn_photons_init(Disk.total_luminosity(), compar1, compar2, agn_com);
+        agn_field.add_blr(Disk.total_luminosity(), compar1);
+        agn_field.add_torus(Disk.total_luminosity(), compar2);
+        const kariba::ExternalField::Source& blr = agn_field.get_sources()[0];
+        const kariba::ExternalField::Source& torus = agn_field.get_sources()[1];
 
-        BLR.set_temp_kev(agn_com.tblr);
-        BLR.set_lum(agn_com.lblr);
+        BLR.set_temp_k(blr.temp);
+        BLR.set_lum(blr.lum);
         BLR.bb_spectrum();
 
-        Torus.set_temp_k(agn_com.tdt);
-        Torus.set_lum(agn_com.ldt);
+        Torus.set_temp_k(torus.temp);
+        Torus.set_lum(torus.lum);
         Torus.bb_spectrum();
 
         Disk.cover_disk(compar1 + compar2);
         if (infosw >= 3) {
-            std::cout << "BLR radius in Rg: " << agn_com.rblr / Rg << " and in cm: " << agn_com.rblr
+            std::cout << "BLR radius in Rg: " << blr.radius / Rg << " and in cm: " << blr.radius
                       << "\n";
-            std::cout << "DT radius in Rg: " << agn_com.rdt / Rg << " and in cm: " << agn_com.rdt
+            std::cout << "DT radius in Rg: " << torus.radius / Rg << " and in cm: " << torus.radius
                       << "\n";
         }
-        sum_ext(40, ne, Torus.get_energy_obs(), Torus.get_nphot_obs(), tot_en, tot_lum);
+        Torus.add_spectrum(tot_en, tot_lum);
         if (l_disk > 0) {
-            sum_ext(50, ne, Disk.get_energy_obs(), Disk.get_nphot_obs(), tot_en, tot_lum);
+            Disk.add_spectrum(tot_en, tot_lum);
         }
     }
 
     // STEP 4: JET BASE EQUIPARTITION CALCULATIONS AND SETUP
-    // Dummy particle distribution, needed for average lorentz factor in
-    // equipartition function The number density is just set to unity, the
-    // normalisation is not needed to calculate the average Lorenz factor of the
-    // thermal distribution anyway
-    kariba::Thermal dummy_elec(nel);
-    dummy_elec.set_temp_kev(t_e);
-    dummy_elec.set_p();
-    dummy_elec.set_norm(1.);
-    dummy_elec.set_ndens();
+    // Average Lorentz factor of the thermal electrons at the jet base, needed in
+    // the equipartition function. This is calculated analytically, so no
+    // particle distribution needs to be set up. As in Particles::av_gamma(), it
+    // is the Lorentz factor corresponding to the average momentum
+    double av_p_base = kariba::Thermal::av_p_mj(t_e, karcst::emgm) / (karcst::emgm * karcst::cee);
+    double av_gamma_base = std::sqrt(std::pow(av_p_base, 2.) + 1.);
 
     grid.nz = nz;
     grid.cut = 0;
@@ -278,7 +285,7 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     nozzle_ener.pbeta = p_beta;
     nozzle_ener.Nj = jetrat;
     nozzle_ener.sig_acc = sig_acc;
-    nozzle_ener.av_gamma = dummy_elec.av_gamma();
+    nozzle_ener.av_gamma = av_gamma_base;
     // set up jet velocity profile depending on choice of
     // adiabatic,isothermal,magnetically dominated jet note: the adiabatic jet
     // only runs correctly if the final temperature is above ~1kev, which means
@@ -300,10 +307,10 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         std::cout << "Unphysical pair content: " << nozzle_ener.eta
                   << " pairs per proton. Check the value of "
                   << "plasma beta!\n";
-    } else if (velsw > 1 && dummy_elec.av_gamma() * nozzle_ener.eta >= 3e2) {
+    } else if (velsw > 1 && av_gamma_base * nozzle_ener.eta >= 3e2) {
         std::cout << "Pair content or temperature too high for  for bljet!\n";
         std::cout << "Pair content: " << nozzle_ener.eta << " pairs per proton\n";
-        std::cout << "Average lepton Lorenz factor: " << dummy_elec.av_gamma() << "\n";
+        std::cout << "Average lepton Lorenz factor: " << av_gamma_base << "\n";
         std::cout << "Check the value of Te and/or plasma beta!\n";
     }
 
@@ -311,13 +318,16 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         std::cout << "Jet base parameters: \n";
         std::cout << "Pair content (ne/np): " << nozzle_ener.eta << "\n";
         std::cout << "Initial magnetization: " << nozzle_ener.sig0 << "\n";
-        std::cout << "Particle average Lorenz factor: " << dummy_elec.av_gamma() << "\n";
+        std::cout << "Particle average Lorenz factor: " << av_gamma_base << "\n";
         std::cout << "Jet nozzle ends at: " << jet_dyn.h0 / Rg << " Rg" << "\n";
         std::cout << "Jet nozzle optical depth: "
                   << jet_dyn.r0 * nozzle_ener.lepdens * karcst::sigtom << "\n\n";
     }
 
     // STEP 5: TOTAL JET CALCULATIONS, LOOPING OVER EACH SEGMENT OF THE JET
+    // The particle distributions are reused across all zones, so their arrays
+    // are allocated only once
+    kariba::ParticlePool particles(nel);
     for (size_t i = 0; i < nz; i++) {
         // calculate dynamics/energetics in each zone
         jetgrid(i, grid, jet_dyn, zone.r, zone.delz, z);
@@ -365,13 +375,12 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         if (compsw == 1) {
             Urad = Urad + std::pow(zone.delta, 2.) * Ubb1;
         } else if (compsw == 2 && r_in < r_out) {
-            zone_agn_phfields(z, zone, Ubb1, Ubb2, agn_com);
-            Urad = Urad + agn_com.urad_total;
+            Urad = Urad + agn_field.cooling_udens(z, zone.gamma, zone.delta, acc_agn_z, acc_agn_g);
         }
 
         // calculate particle distribution in each zone
         if (zone.nth_frac == 0.) {
-            kariba::Thermal th_lep(nel);
+            kariba::Thermal& th_lep = particles.get_thermal();
             th_lep.set_temp_kev(zone.eltemp);
             th_lep.set_p();
             th_lep.set_norm(zone.lepdens);
@@ -398,7 +407,7 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
                 zone.eltemp =
                     std::max(tshift * t_e * std::pow(log10(z_diss) / std::log10(z), f_pl), 1.);
             }
-            kariba::Mixed acc_lep(nel);
+            kariba::Mixed& acc_lep = particles.get_mixed();
             acc_lep.set_temp_kev(zone.eltemp);
             acc_lep.set_pspec(pspec);
             acc_lep.set_plfrac(zone.nth_frac);
@@ -437,14 +446,9 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
                     std::max(tshift * t_e * std::pow(log10(z_diss) / std::log10(z), f_pl), 1.);
                 IsShock = true;
             }
-            kariba::Thermal dummy_elec(nel);
-            dummy_elec.set_temp_kev(zone.eltemp);
-            dummy_elec.set_p();
-            dummy_elec.set_norm(zone.lepdens);
-            dummy_elec.set_ndens();
-            double pbrk = dummy_elec.av_p();
-
-            kariba::Bknpower acc_lep(nel);
+            double pbrk = kariba::Thermal::av_p_mj(zone.eltemp, karcst::emgm);
+
+            kariba::Bknpower& acc_lep = particles.get_bknpower();
             acc_lep.set_pspec1(-2.);
             acc_lep.set_pspec2(pspec);
 
@@ -480,14 +484,9 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
                     std::max(tshift * t_e * std::pow(log10(z_diss) / std::log10(z), f_pl), 1.);
                 IsShock = true;
             }
-            kariba::Thermal dummy_elec(nel);
-            dummy_elec.set_temp_kev(zone.eltemp);
-            dummy_elec.set_p();
-            dummy_elec.set_norm(zone.lepdens);
-            dummy_elec.set_ndens();
-            double pmin = dummy_elec.av_p();
-
-            kariba::Powerlaw acc_lep(nel);
+            double pmin = kariba::Thermal::av_p_mj(zone.eltemp, karcst::emgm);
+
+            kariba::Powerlaw& acc_lep = particles.get_powerlaw();
             acc_lep.set_pspec(pspec);
 
             if (f_sc < 10.) {
@@ -608,24 +607,33 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
             if (InvCompton.get_ypar() > 1.e-2 && InvCompton.get_tau() > 5.e-2) {
                 InvCompton.set_niter(15);
             }
-            // Cyclosynchrotron photons are always considered in the scattering
-            InvCompton.cyclosyn_seed(Syncro.get_energy(), Syncro.get_nphot());
+            // Cyclosynchrotron photons are always considered in the scattering;
+            // all fields are summed first, and the seed field set up once
+            InvCompton.add_cyclosyn_seed(Syncro.get_energy(), Syncro.get_nphot());
 
             // Disk photons are included only if the disk is present
             if (r_in < r_out) {
-                InvCompton.shsdisk_seed(Syncro.get_energy(), Disk.tin(), r_in, r_out, Disk.hdisk(),
-                                        z + zone.delz / 2.);
+                InvCompton.add_shsdisk_seed(Syncro.get_energy(), Disk.tin(), r_in, r_out,
+                                            Disk.hdisk(), z + zone.delz / 2.);
             }
             // Black body photons included only if compsw==1
             if (compsw == 1) {
-                InvCompton.bb_seed_k(Syncro.get_energy(), Ubb1, zone.delta * BlackBody.temp_k());
+                InvCompton.add_bb_seed_k(Syncro.get_energy(), Ubb1,
+                                         zone.delta * BlackBody.temp_k());
             }
             // AGN photon fields photons are considered only if disk is present
             // and compsw==2
             if (compsw == 2 && r_in < r_out) {
-                InvCompton.bb_seed_k(Syncro.get_energy(), Ubb1, zone.delta * BLR.temp_k());
-                InvCompton.bb_seed_k(Syncro.get_energy(), Ubb2, zone.delta * Torus.temp_k());
+                const std::vector<kariba::ExternalField::Source>& sources =
+                    agn_field.get_sources();
+                for (size_t k = 0; k < sources.size(); k++) {
+                    double udens = agn_field.comoving_udens(k, z, zone.gamma, zone.delta,
+                                                            acc_agn_z, acc_agn_g);
+                    InvCompton.add_bb_seed_k(Syncro.get_energy(), udens,
+                                             zone.delta * sources[k].temp);
+                }
             }
+            InvCompton.init_seed();
             // Calculate the spectrum with whichever fields have been invoked
             InvCompton.compton_spectrum(gmin, gmax, spline_eldis, acc_eldis);
             sum_counterjet(ncom, InvCompton.get_energy_obs(), InvCompton.get_nphot_obs(), com_en,
@@ -659,12 +667,15 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     }
 
     // Apply EBL attenuation factor for extragalactic sources
+    // The curve is cached for the redshift and energy grid, so it is only
+    // interpolated from the EBL model once per fit at fixed redshift
     if (redsh > 0. && EBLsw == 1) {
-        kariba::ebl_atten_gil(tot_en, tot_lum, redsh);    // correction for total luminosity
-        kariba::ebl_atten_gil(tot_en, tot_com_post,
-                              redsh);    // correction for post Compton luminosity
+        std::shared_ptr<const kariba::EBLCurve> ebl = kariba::gilmore_curve(tot_en, redsh);
+        ebl->apply(tot_com_post);    // correction for post Compton luminosity
+        output_spectrum(ne, tot_en, tot_lum, photspec, redsh, dist, *ebl);
+    } else {
+        output_spectrum(ne, tot_en, tot_lum, photspec, redsh, dist);
     }
-    output_spectrum(ne, tot_en, tot_lum, photspec, redsh, dist);
 
     // Output to files and print information on terminal if user requires it
     if (infosw >= 1) {
@@ -672,20 +683,21 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
         plot_write(ne, tot_en, tot_syn_post, "Output/Postsyn.dat", dist, redsh);
         plot_write(ne, tot_en, tot_com_pre, "Output/Precom.dat", dist, redsh);
         plot_write(ne, tot_en, tot_com_post, "Output/Postcom.dat", dist, redsh);
-        plot_write(50, Disk.get_energy_obs(), Disk.get_nphot_obs(), "Output/Disk.dat", dist, redsh);
+        plot_write(Disk.get_size(), Disk.get_energy_obs(), Disk.get_nphot_obs(), "Output/Disk.dat",
+                   dist, redsh);
         if (compsw == 2) {
-            plot_write(40, Torus.get_energy_obs(), Torus.get_nphot_obs(), "Output/BB.dat", dist,
-                       redsh);
+            plot_write(Torus.get_size(), Torus.get_energy_obs(), Torus.get_nphot_obs(),
+                       "Output/BB.dat", dist, redsh);
         } else {
-            plot_write(40, BlackBody.get_energy_obs(), BlackBody.get_nphot_obs(), "Output/BB.dat",
-                       dist, redsh);
+            plot_write(BlackBody.get_size(), BlackBody.get_energy_obs(), BlackBody.get_nphot_obs(),
+                       "Output/BB.dat", dist, redsh);
         }
         plot_write(ne, tot_en, tot_lum, "Output/Total.dat", dist, redsh);
     }
     if (infosw >= 3) {
         double disk_lum, IC_lum, Xray_lum, Radio_lum, Xray_index, Radio_index, compactness;
-        disk_lum = integrate_lum(50, 0.3 * 2.41e17, 5. * 2.41e17, Disk.get_energy_obs(),
-                                 Disk.get_nphot_obs());
+        disk_lum = integrate_lum(Disk.get_size(), 0.3 * 2.41e17, 5. * 2.41e17,
+                                 Disk.get_energy_obs(), Disk.get_nphot_obs());
         IC_lum = integrate_lum(ne, 0.3 * 2.41e17, 300. * 2.41e17, tot_en, tot_com_pre);
         Xray_lum = integrate_lum(ne, 1. * 2.41e17, 10. * 2.41e17, tot_en, tot_lum);
         Radio_lum = integrate_lum(ne, 4e9, 6e9, tot_en, tot_lum);
@@ -717,4 +729,9 @@ void jetmain(std::vector<double>& ear, size_t ne, std::vector<double>& param,
     gsl_spline_free(spline_eldis), gsl_interp_accel_free(acc_eldis);
     gsl_spline_free(spline_deriv), gsl_interp_accel_free(acc_deriv);
     gsl_spline_free(spline_speed), gsl_interp_accel_free(acc_speed);
+    gsl_interp_accel_free(acc_agn_z), gsl_interp_accel_free(acc_agn_g);
+
+    // write the diagnostics of this run, so that they neither pile up over the
+    // calls of a fit nor get lost if it is stopped
+    kariba::diagnostics().flush();
 }
@@ -19,6 +19,9 @@
 #include <sstream>
 #include <string>
 
+#include <kariba/EBL.hpp>
+#include <kariba/Span.hpp>
+
 // Most functions in the code use input parameters arranged in a structure
 // rather than passed as a long list of multiple int/double variables. The
 // reason for this is imply to make the code easier to read and understand.
@@ -73,19 +76,6 @@ typedef struct zone_pars {
     double nth_frac;     // fraction of non-thermal particles in the zone
 } zone_pars;
 
-// Structure with parameters needed for external inverse Compton photon fields
-typedef struct com_pars {
-    double lblr;          // luminosity of BLR
-    double ublr;          // energy density of BLR
-    double tblr;          // temperature of BLR
-    double rblr;          // radius of BLR
-    double ldt;           // luminosity of torus
-    double udt;           // energy density of torus
-    double tdt;           // temperature of torus
-    double rdt;           // radius of torus
-    double urad_total;    // total energy density
-} com_pars;
-
 void jetmain(std::vector<double>& ear, int ne, std::vector<double>& param,
              std::vector<double>& photeng, std::vector<double>& photspec);
 
@@ -95,8 +85,8 @@ void plot_write(size_t size, const std::vector<double>& en, const std::vector<do
 // void plot_write(size_t size, const std::vector<double> &en, const
 // std::vector<double> &lum, 		const std::string& path, double dist, double
 // redshift);
-void plot_write(size_t size, const std::vector<double>& p, const std::vector<double>& g,
-                const std::vector<double>& pdens, const std::vector<double>& gdens,
+void plot_write(size_t size, kariba::Span<const double> p, kariba::Span<const double> g,
+                kariba::Span<const double> pdens, kariba::Span<const double> gdens,
                 const std::string& path);
 
 bool Compton_check(bool IsShock, size_t i, double Mbh, double Nj, double Ucom, double velsw,
@@ -107,11 +97,11 @@ void sum_counterjet(size_t size, const std::vector<double>& input_en,
                     std::vector<double>& lum);
 void output_spectrum(size_t size, std::vector<double>& en, std::vector<double>& lum,
                      std::vector<double>& spec, double redsh, double dist);
+void output_spectrum(size_t size, std::vector<double>& en, std::vector<double>& lum,
+                     std::vector<double>& spec, double redsh, double dist,
+                     const kariba::EBLCurve& ebl);
 void sum_zones(size_t size_in, size_t size_out, std::vector<double>& input_en,
                std::vector<double>& input_lum, std::vector<double>& en, std::vector<double>& lum);
-void sum_ext(size_t size_in, size_t size_out, const std::vector<double>& input_en,
-             const std::vector<double>& input_lum, std::vector<double>& en,
-             std::vector<double>& lum);
 double integrate_lum(size_t size, double numin, double numax, const std::vector<double>& input_en,
                      const std::vector<double>& input_lum);
 double photon_index(size_t size, double numin, double numax, const std::vector<double>& input_en,
@@ -133,10 +123,6 @@ void bljetpars(double z, jet_dynpars& dyn, jet_enpars& en, double& t, zone_pars&
                gsl_spline* spline, gsl_interp_accel* acc);
 void b_profile(double g, double n, jet_dynpars& dyn, jet_enpars& en, double& field);
 
-void agn_photons_init(double lum, double f1, double f2, com_pars& agn_com);
-void zone_agn_phfields(double z, zone_pars& zone, double& ublr_zone, double& udt_zone,
-                       com_pars& agn_com);
-
 void clean_file(std::string path, int check);
 void jetinterp(std::vector<double>& ear, std::vector<double>& energ, std::vector<double>& phot,
                std::vector<double>& photar, size_t ne, size_t newne);
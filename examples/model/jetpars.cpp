@@ -301,105 +301,3 @@ void b_profile(double gam, double n, jet_dynpars& dyn, jet_enpars& en, double& f
     field = std::sqrt(sigma * 4. * karcst::pi *
                       (n / en.eta * karcst::pmgm * std::pow(karcst::cee, 2.) + w));
 }
-
-// This function is used to set up the external AGN photon fields (torus, BLR)
-// as a function of accretion rate See Ghisellini and Tavecchio 2009 for details
-void agn_photons_init(double lum, double f1, double f2, com_pars& agn_com) {
-    agn_com.rblr = 1.e17 * std::pow(lum / 1.e45, 1. / 2.);
-    agn_com.ublr =
-        (17. / 12.) * f1 * lum / (4. * karcst::pi * std::pow(agn_com.rblr, 2.) * karcst::cee);
-    agn_com.tblr = 10.2e-3;    // temperature of the BLR photons in kev
-    agn_com.lblr =
-        (12. / 17.) * 4. * karcst::pi * std::pow(agn_com.rblr, 2.) * karcst::cee * agn_com.ublr;
-
-    agn_com.rdt = 2.5e18 * std::pow(lum / 1.e45, 1. / 2.);
-    agn_com.udt = f2 * lum / (4. * karcst::pi * std::pow(agn_com.rdt, 2.) * karcst::cee);
-    agn_com.tdt = 370.;    // temperature of the torus photons in Kelvin
-    agn_com.ldt = 4. * karcst::pi * std::pow(agn_com.rdt, 2.) * karcst::cee * agn_com.udt;
-}
-
-// This function calculates the energy densities for the standard AGN photon
-// fields (BLR and torus), taking beaming/debeaming into account. It sets the
-// the total energy density in agn_com (used for cooling and for the IC
-// estimate), as well as the individual energy densities, used in the actual IC
-// calculations. The reason the last two are not part of agn_com is that
-// agn_com.ublr and agn_com.udt are calculated in the observer frame while
-// ublr_zone and udt_zone are in the jet comoving frame. The reason why ublr/udt
-// are multiplied by delta^2 instead of gamma^2 as in Dermer, 1995. Because of
-// this, when we compute urad_total (which goes to the cooling term) we
-// sometimes need to convert again with a factor gamma/delta^2
-void zone_agn_phfields(double z, zone_pars& zone, double& ublr_zone, double& udt_zone,
-                       com_pars& agn_com) {
-    // these are to calculate the conversion factor to account for z>zblr/zdt,
-    // when photons are deboosted. See Ghisellini&Tavecchio 2009
-    double blr_conv, dt_conv, mu_blr1, mu_blr2, mu_dt1, mu_dt2, fr;
-    fr = 12. / 17.;    // the only reason this variable is here is to save space
-                       // in the code
-
-    if (z < agn_com.rblr) {    // for low z both photon fields are boosted
-        ublr_zone = std::pow(zone.delta, 2.) * agn_com.ublr;
-        udt_zone = std::pow(zone.delta, 2.) * agn_com.udt;
-        agn_com.urad_total = std::pow(zone.gamma, 2.) * (agn_com.udt + agn_com.ublr);
-    } else if (z < 3. * agn_com.rblr) {    // BLR starts being slightly deboosted
-        double blr_boost, blr_interp;
-        mu_blr1 = std::pow(10. / 9., -1. / 2.);
-        mu_blr2 = std::pow(8. / 9., 1. / 2.);
-        blr_conv = 2. * std::pow(1. - zone.beta * mu_blr1, 3.) -
-                   std::pow(1. - zone.beta * mu_blr2, 3.) - std::pow(1. - zone.beta, 3.);
-        blr_boost = std::pow(zone.delta, 2.) * agn_com.ublr;
-        blr_interp = std::pow(zone.delta, 2.) * agn_com.ublr * blr_conv / (3. * zone.beta);
-
-        ublr_zone = blr_boost + (z - agn_com.rblr) / (2. * agn_com.rblr) * (blr_interp - blr_boost);
-        udt_zone = std::pow(zone.delta, 2.) * agn_com.udt;
-        agn_com.urad_total = std::pow(zone.gamma, 2.) *
-                             (agn_com.udt + ublr_zone * std::pow(zone.gamma / zone.delta, 2.));
-    } else if (z < agn_com.rdt) {    // for intermediate z BLR is deboosted,
-                                     // torus is boosted
-        mu_blr1 = std::pow(1. + std::pow(agn_com.rblr / z, 2.), -1. / 2.);    //
-        mu_blr2 = std::pow(1. - std::pow(agn_com.rblr / z, 2.), 1. / 2.);
-        blr_conv = 2. * std::pow(1. - zone.beta * mu_blr1, 3.) -
-                   std::pow(1. - zone.beta * mu_blr2, 3.) - std::pow(1. - zone.beta, 3.);
-
-        ublr_zone = std::pow(zone.delta, 2.) * agn_com.ublr * blr_conv / (3. * zone.beta);
-        udt_zone = std::pow(zone.delta, 2.) * agn_com.udt;
-        agn_com.urad_total = std::pow(zone.gamma, 2.) *
-                             (agn_com.udt + fr * agn_com.ublr * blr_conv / (3. * zone.beta));
-    } else if (z < 3. * agn_com.rdt) {    // BLR fully deboosted, DT slightly deboosted
-        mu_blr1 = std::pow(1. + std::pow(agn_com.rblr / z, 2.), -1. / 2.);
-        mu_blr2 = std::pow(1. - std::pow(agn_com.rblr / z, 2.), 1. / 2.);
-        blr_conv = 2. * std::pow(1. - zone.beta * mu_blr1, 3.) -
-                   std::pow(1. - zone.beta * mu_blr2, 3.) - std::pow(1. - zone.beta, 3.);
-
-        ublr_zone = std::pow(zone.delta, 2.) * agn_com.ublr * blr_conv / (3. * zone.beta);
-
-        double dt_boost, dt_interp;
-        mu_dt1 = std::pow(10. / 9., -1. / 2.);
-        mu_dt2 = std::pow(8. / 9., 1. / 2.);
-        dt_conv = 2. * std::pow(1. - zone.beta * mu_dt1, 3.) -
-                  std::pow(1. - zone.beta * mu_dt2, 3.) - std::pow(1. - zone.beta, 3.);
-        dt_boost = std::pow(zone.delta, 2.) * agn_com.udt;
-        dt_interp = std::pow(zone.delta, 2.) * agn_com.udt * dt_conv / (3. * zone.beta);
-
-        udt_zone = dt_boost + (z - agn_com.rdt) / (2. * agn_com.rdt) * (dt_interp - dt_boost);
-        agn_com.urad_total =
-            std::pow(zone.gamma, 2.) * (udt_zone * std::pow(zone.gamma / zone.delta, 2.) +
-                                        fr * agn_com.ublr * blr_conv / (3. * zone.beta));
-
-    } else {    // for high z both photon fields are deboosted
-        mu_blr1 = std::pow(1. + std::pow(agn_com.rblr / z, 2.), -1. / 2.);
-        mu_blr2 = std::pow(1. - std::pow(agn_com.rblr / z, 2.), 1. / 2.);
-        blr_conv = 2. * std::pow(1. - zone.beta * mu_blr1, 3.) -
-                   std::pow(1. - zone.beta * mu_blr2, 3.) - std::pow(1. - zone.beta, 3.);
-
-        mu_dt1 = std::pow(1. + std::pow(agn_com.rdt / z, 2.), -1. / 2.);
-        mu_dt2 = std::pow(1. - std::pow(agn_com.rdt / z, 2.), 1. / 2.);
-        dt_conv = 2. * std::pow(1. - zone.beta * mu_dt1, 3.) -
-                  std::pow(1. - zone.beta * mu_dt2, 3.) - std::pow(1. - zone.beta, 3.);
-
-        ublr_zone = std::pow(zone.delta, 2.) * agn_com.ublr * blr_conv / (3. * zone.beta);
-        udt_zone = std::pow(zone.delta, 2.) * agn_com.udt * dt_conv / (3. * zone.beta);
-        agn_com.urad_total = std::pow(zone.gamma, 2.) *
-                             (agn_com.udt * dt_conv + fr * agn_com.ublr * blr_conv) /
-                             (3. * zone.beta);
-    }
-}
@@ -83,8 +83,8 @@ void plot_write(size_t size, const std::vector<double>& en, const std::vector<do
 }
 
 // Same as above but for particle distributions
-void plot_write(size_t size, const std::vector<double>& p, const std::vector<double>& g,
-                const std::vector<double>& pdens, const std::vector<double>& gdens,
+void plot_write(size_t size, kariba::Span<const double> p, kariba::Span<const double> g,
+                kariba::Span<const double> pdens, kariba::Span<const double> gdens,
                 const std::string& path) {
 
     std::ofstream file;
@@ -176,12 +176,20 @@ void output_spectrum(size_t size, std::vector<double>& en, std::vector<double>&
     gsl_spline_free(input_spline), gsl_interp_accel_free(acc);
 }
 
+// Same as above, for a spectrum attenuated by the EBL. The attenuation is
+// applied to lum in place, as it is also written out and integrated.
+void output_spectrum(size_t size, std::vector<double>& en, std::vector<double>& lum,
+                     std::vector<double>& spec, double redsh, double dist,
+                     const kariba::EBLCurve& ebl) {
+    ebl.apply(lum);
+    output_spectrum(size, en, lum, spec, redsh, dist);
+}
+
 // Used for summing individual zone contributions for a generic spectral
 // component from code: pre/post particle acceleration synchrotron, pre/post
-// particle acceleration Comptonization The second function does the same, but
-// sums the disk/corona/bb to the total jet spectrum. The reason for the const
-// arryas in input is that the input arrays are directly accessed from the
-// ShSDisk class, which are const
+// particle acceleration Comptonization. The disk and black bodies are added to
+// the total jet spectrum directly on its grid, with ShSDisk::add_spectrum and
+// BBody::add_spectrum
 void sum_zones(size_t size_in, size_t size_out, std::vector<double>& input_en,
                std::vector<double>& input_lum, std::vector<double>& en, std::vector<double>& lum) {
     gsl_interp_accel* acc = gsl_interp_accel_alloc();
@@ -196,21 +204,6 @@ void sum_zones(size_t size_in, size_t size_out, std::vector<double>& input_en,
     gsl_spline_free(input_spline), gsl_interp_accel_free(acc);
 }
 
-void sum_ext(size_t size_in, size_t size_out, const std::vector<double>& input_en,
-             const std::vector<double>& input_lum, std::vector<double>& en,
-             std::vector<double>& lum) {
-    gsl_interp_accel* acc = gsl_interp_accel_alloc();
-    gsl_spline* input_spline = gsl_spline_alloc(gsl_interp_akima, size_in);
-    gsl_spline_init(input_spline, input_en.data(), input_lum.data(), size_in);
-
-    for (size_t i = 0; i < size_out; i++) {
-        if (en[i] > input_en[0] && en[i] < input_en[size_in - 1]) {
-            lum[i] = lum[i] + gsl_spline_eval(input_spline, en[i], acc);
-        }
-    }
-    gsl_spline_free(input_spline), gsl_interp_accel_free(acc);
-}
-
 // Simple numerical integral to calculate the luminosity between numin and numax
 // of a given array; input units are erg for the frequency/energy array,
 // erg/s/Hz for the luminosity array to be integrated, Hz for the integration
@@ -45,8 +45,8 @@ void plot_write(size_t size, const std::vector<double>& en, const std::vector<do
     file.close();
 }
 
-void plot_write(size_t size, const std::vector<double>& p, const std::vector<double>& g,
-                const std::vector<double>& pdens, const std::vector<double>& gdens,
+void plot_write(size_t size, kariba::Span<const double> p, kariba::Span<const double> g,
+                kariba::Span<const double> pdens, kariba::Span<const double> gdens,
                 const std::string& path) {
 
     std::ofstream file;
@@ -1,5 +1,6 @@
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "kariba/BBody.hpp"
 #include "kariba/constants.hpp"
@@ -73,6 +74,19 @@ void BBody::bb_spectrum() {
     }
 }
 
+void BBody::add_spectrum(const std::vector<double>& en, std::vector<double>& lum) const {
+    const double emin = en_phot_obs.front(), emax = en_phot_obs.back();
+    const double kT = Tbb * constants::kboltz;
+    const double norm = normbb * 2. * constants::pi /
+                        (constants::herg * constants::herg * std::pow(constants::cee, 2.));
+    const size_t size = en.size();
+    for (size_t i = 0; i < size; i++) {
+        double e = en[i];
+        double nphot = norm * e * e * e / (std::exp(e / kT) - 1.);
+        lum[i] = (e > emin && e < emax) ? lum[i] + nphot : lum[i];
+    }
+}
+
 //! Methods to return BB temperature, luminosity, energy density at a given
 //! distance d (or for a given radius d of the source)
 double BBody::temp_kev() const { return Tbb * constants::kboltz / constants::kboltz_kev2erg; }
@@ -0,0 +1,96 @@
+#include <cmath>
+
+#include "kariba/Bessel.hpp"
+
+namespace kariba {
+
+//! Polynomial approximation of I_0(x) for |x| <= 3.75 (A&S 9.8.1)
+static double bessel_i0_small(double x) {
+    double y = (x / 3.75) * (x / 3.75);
+
+    return 1.0 +
+           y * (3.5156229 +
+                y * (3.0899424 +
+                     y * (1.2067492 + y * (0.2659732 + y * (0.0360768 + y * 0.0045813)))));
+}
+
+//! Polynomial approximation of I_1(x) for |x| <= 3.75 (A&S 9.8.3)
+static double bessel_i1_small(double x) {
+    double y = (x / 3.75) * (x / 3.75);
+
+    return x * (0.5 + y * (0.87890594 +
+                           y * (0.51498869 +
+                                y * (0.15084934 +
+                                     y * (0.02658733 + y * (0.00301532 + y * 0.00032411))))));
+}
+
+double bessel_k0(double x) {
+    double y;
+
+    if (x <= 2.) {
+        // A&S 9.8.5
+        y = 0.25 * x * x;
+        return -std::log(0.5 * x) * bessel_i0_small(x) +
+               (-0.57721566 +
+                y * (0.42278420 +
+                     y * (0.23069756 +
+                          y * (0.03488590 + y * (0.00262698 + y * (0.00010750 + y * 0.0000074))))));
+    }
+
+    return std::exp(-x) * bessel_k0_scaled(x);
+}
+
+double bessel_k0_scaled(double x) {
+    double y;
+
+    if (x <= 2.) {
+        return std::exp(x) * bessel_k0(x);
+    }
+
+    // A&S 9.8.6
+    y = 2. / x;
+    return 1. / std::sqrt(x) *
+           (1.25331414 +
+            y * (-0.07832358 +
+                 y * (0.02189568 +
+                      y * (-0.01062446 + y * (0.00587872 + y * (-0.00251540 + y * 0.00053208))))));
+}
+
+double bessel_k1(double x) {
+    double y;
+
+    if (x <= 2.) {
+        // A&S 9.8.7
+        y = 0.25 * x * x;
+        return std::log(0.5 * x) * bessel_i1_small(x) +
+               (1. / x) *
+                   (1. + y * (0.15443144 +
+                              y * (-0.67278579 +
+                                   y * (-0.18156897 +
+                                        y * (-0.01919402 + y * (-0.00110404 + y * -0.00004686))))));
+    }
+
+    return std::exp(-x) * bessel_k1_scaled(x);
+}
+
+double bessel_k1_scaled(double x) {
+    double y;
+
+    if (x <= 2.) {
+        return std::exp(x) * bessel_k1(x);
+    }
+
+    // A&S 9.8.8
+    y = 2. / x;
+    return 1. / std::sqrt(x) *
+           (1.25331414 +
+            y * (0.23498619 +
+                 y * (-0.03655620 +
+                      y * (0.01504268 + y * (-0.00780353 + y * (0.00325614 + y * -0.00068245))))));
+}
+
+double bessel_k2(double x) { return bessel_k0(x) + 2. * bessel_k1(x) / x; }
+
+double bessel_k2_scaled(double x) { return bessel_k0_scaled(x) + 2. * bessel_k1_scaled(x) / x; }
+
+}    // namespace kariba
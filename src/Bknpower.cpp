@@ -10,7 +10,11 @@
 
 namespace kariba {
 
-Bknpower::Bknpower(size_t size) : Particles(size) {
+Bknpower::Bknpower(size_t size) : Particles(size) { reset(); }
+
+void Bknpower::reset() {
+    Particles::reset();
+
     norm = 1.;
 
     mass_gr = constants::emgm;
@@ -68,7 +68,8 @@ Compton::~Compton() {
 }
 
 Compton::Compton(size_t size, size_t seed_size)
-    : Radiation(size), seed_energ(seed_size, 0.0), seed_urad(seed_size, 0.0), iter_urad(size, 0.0) {
+    : Radiation(size), seed_energ(seed_size, 0.0), seed_urad(seed_size, 0.0), iter_urad(size, 0.0),
+      seed_field(seed_size, 0.0) {
     en_phot_obs.resize(en_phot_obs.size() * 2, 0.0);
     num_phot_obs.resize(num_phot_obs.size() * 2, 0.0);
 
@@ -240,83 +241,93 @@ void Compton::compton_spectrum(double gmin, double gmax, gsl_spline* eldis,
 
 //! Method to include cyclosynchrotron array from Cyclosyn.hh to the seed field.
 //! The two input arrays should be get_energ() and get_nphot() methods from
-//! Cyclosyn.hh. If the seed_urad array wasn't empty, the contribution is
-//! automatically added to the existing one. note: the second condition has a <=
-//! sign to dodge numerical errors when the seed field energy density is
-//! extremely low, which can result in negative values/nan for the seed_urad
+//! Cyclosyn.hh. If the seed field wasn't empty, the contribution is
+//! automatically added to the existing one.
 void Compton::cyclosyn_seed(const std::vector<double>& seed_arr,
                             const std::vector<double>& seed_lum) {
+    add_cyclosyn_seed(seed_arr, seed_lum);
+    init_seed();
+}
+
+void Compton::add_cyclosyn_seed(const std::vector<double>& seed_arr,
+                                const std::vector<double>& seed_lum) {
     // to do: asssert input and member sizes are the same
-    for (size_t i = 0; i < seed_arr.size(); i++) {
-        seed_energ[i] = seed_arr[i];
-        if (seed_urad[i] != 0) {
-            seed_urad[i] = std::log10(std::pow(10., seed_urad[i]) +
-                                      seed_lum[i] / (constants::cee * constants::herg *
-                                                     seed_energ[i] * constants::pi * r * r));
-        } else if (seed_lum[i] /
-                       (constants::cee * constants::herg * seed_energ[i] * constants::pi * r * r) <=
-                   0) {
-            seed_urad[i] = -100;
-        } else {
-            seed_urad[i] = std::log10(seed_lum[i] / (constants::cee * constants::herg *
-                                                     seed_energ[i] * constants::pi * r * r));
-        }
+    seed_freq_array(seed_arr);
+    seed_field.resize(seed_energ.size(), 0.);
+    const double norm = 1. / (constants::cee * constants::herg * constants::pi * r * r);
+    const size_t size = seed_arr.size();
+#pragma omp simd
+    for (size_t i = 0; i < size; i++) {
+        seed_field[i] += seed_lum[i] * norm / seed_energ[i];
+    }
+}
+
+void Compton::add_field_seed(const PhotonField& field) {
+    seed_freq_array(field.get_energy());
+    seed_field.resize(seed_energ.size(), 0.);
+    const std::vector<double>& density = field.get_density();
+    const double radius = field.get_radius();
+    const double norm = field.get_volume() / (constants::pi * radius * radius * radius);
+    const size_t size = field.size();
+#pragma omp simd
+    for (size_t i = 0; i < size; i++) {
+        seed_field[i] += density[i] * norm;
+    }
+}
+
+//! Planck number density of a black body of temperature kT (in erg) and
+//! energy density Urad at the seed energies below ulim, added to the seed
+//! field; above ulim a negligible floor is added instead
+static void add_planck(const std::vector<double>& seed_energ, std::vector<double>& seed_field,
+                       double Urad, double kT, double ulim) {
+    // 2 Urad E^2 / (h^3 c^2 σ T^4 (exp(E/kT) - 1))
+    const double T = kT / constants::kboltz;
+    const double norm = 2. * Urad /
+                        (std::pow(constants::herg, 3.) * std::pow(constants::cee, 2.) *
+                         constants::sbconst * T * T * T * T);
+    const size_t size = seed_energ.size();
+    for (size_t i = 0; i < size; i++) {
+        double e = seed_energ[i];
+        double bbfield = e < ulim ? norm * e * e / (std::exp(e / kT) - 1.) : 1.e-100;
+        seed_field[i] += bbfield;
     }
-    gsl_spline_init(seed_ph, seed_energ.data(), seed_urad.data(), seed_energ.size());
 }
 
 //! Method to include black body to seed field for IC;
 //! Note: Urad and Tbb need to be passed in the co-moving frame, the function
 //! does NOT account for beaming
 void Compton::bb_seed_k(const std::vector<double>& seed_arr, double Urad, double Tbb) {
-    double ulim, bbfield;
-
-    ulim = 1e2 * Tbb * constants::kboltz;
-    // seed_freq_array(seed_arr);
-    seed_energ = seed_arr;
-
-    for (size_t i = 0; i < seed_arr.size(); i++) {
-        if (seed_energ[i] < ulim) {
-            bbfield = (2. * Urad * std::pow(seed_energ[i] / constants::herg, 2.)) /
-                      (constants::herg * std::pow(constants::cee, 2.) * constants::sbconst *
-                       std::pow(Tbb, 4) * (exp(seed_energ[i] / (constants::kboltz * Tbb)) - 1.));
-        } else {
-            bbfield = 1.e-100;
-        }
-        if (seed_urad[i] != 0) {
-            seed_urad[i] = std::log10(std::pow(10., seed_urad[i]) + bbfield);
-        } else if (bbfield > 0) {
-            seed_urad[i] = std::log10(bbfield);
-        } else {
-            seed_urad[i] = -100;
-        }
-    }
-    gsl_spline_init(seed_ph, seed_energ.data(), seed_urad.data(), seed_energ.size());
+    add_bb_seed_k(seed_arr, Urad, Tbb);
+    init_seed();
 }
 
 void Compton::bb_seed_kev(const std::vector<double>& seed_arr, double Urad, double Tbb) {
-    double ulim, bbfield;
+    add_bb_seed_kev(seed_arr, Urad, Tbb);
+    init_seed();
+}
 
-    ulim = 1e2 * Tbb * constants::kboltz_kev2erg;
-    // seed_freq_array(seed_arr);
+void Compton::add_bb_seed_k(const std::vector<double>& seed_arr, double Urad, double Tbb) {
     seed_energ = seed_arr;
+    seed_field.resize(seed_energ.size(), 0.);
+    add_planck(seed_energ, seed_field, Urad, Tbb * constants::kboltz,
+               1e2 * Tbb * constants::kboltz);
+}
 
-    for (size_t i = 0; i < seed_arr.size(); i++) {
-        if (seed_energ[i] < ulim) {
-            bbfield = (2. * Urad * std::pow(seed_energ[i] / constants::herg, 2.)) /
-                      (constants::herg * std::pow(constants::cee, 2.) * constants::sbconst *
-                       std::pow(Tbb * constants::kboltz_kev2erg / constants::kboltz, 4) *
-                       (exp(seed_energ[i] / (Tbb * constants::kboltz_kev2erg)) - 1.));
-        } else {
-            bbfield = 1.e-100;
-        }
-        if (seed_urad[i] != 0) {
-            seed_urad[i] = std::log10(std::pow(10., seed_urad[i]) + bbfield);
-        } else if (bbfield > 0) {
-            seed_urad[i] = std::log10(bbfield);
-        } else {
-            seed_urad[i] = -100;
-        }
+void Compton::add_bb_seed_kev(const std::vector<double>& seed_arr, double Urad, double Tbb) {
+    seed_energ = seed_arr;
+    seed_field.resize(seed_energ.size(), 0.);
+    add_planck(seed_energ, seed_field, Urad, Tbb * constants::kboltz_kev2erg,
+               1e2 * Tbb * constants::kboltz_kev2erg);
+}
+
+//! Sets up the interpolation of the seed field, in log10, from the fields
+//! added so far. note: a field that is zero or negative, which can happen
+//! when the seed field energy density is extremely low, is set to 1e-100 to
+//! dodge negative values/nan
+void Compton::init_seed() {
+    seed_urad.resize(seed_field.size());
+    for (size_t i = 0; i < seed_field.size(); i++) {
+        seed_urad[i] = seed_field[i] > 0 ? std::log10(seed_field[i]) : -100;
     }
     gsl_spline_init(seed_ph, seed_energ.data(), seed_urad.data(), seed_energ.size());
 }
@@ -357,6 +368,12 @@ double disk_integral(double alfa, void* pars) {
 
 void Compton::shsdisk_seed(const std::vector<double>& seed_arr, double tin, double rin, double rout,
                            double h, double z) {
+    add_shsdisk_seed(seed_arr, tin, rin, rout, h, z);
+    init_seed();
+}
+
+void Compton::add_shsdisk_seed(const std::vector<double>& seed_arr, double tin, double rin,
+                               double rout, double h, double z) {
     double ulim, blim, nulim, Gamma, result, error, diskfield;
 
     Gamma = 1. / std::pow((1. - std::pow(beta, 2.)), 1. / 2.);
@@ -370,6 +387,7 @@ void Compton::shsdisk_seed(const std::vector<double>& seed_arr, double tin, doub
     nulim = 1e1 * tin * constants::kboltz;
     // seed_freq_array(seed_arr);
     seed_energ = seed_arr;
+    seed_field.resize(seed_energ.size(), 0.);
 
     for (size_t i = 0; i < seed_energ.size(); i++) {
         if (seed_energ[i] < nulim) {
@@ -387,15 +405,8 @@ void Compton::shsdisk_seed(const std::vector<double>& seed_arr, double tin, doub
         } else {
             diskfield = 1.e-100;
         }
-        if (seed_urad[i] != 0) {
-            seed_urad[i] = std::log10(std::pow(10., seed_urad[i]) + diskfield);
-        } else if (diskfield > 0) {
-            seed_urad[i] = std::log10(diskfield);
-        } else {
-            seed_urad[i] = -100;
-        }
+        seed_field[i] += diskfield;
     }
-    gsl_spline_init(seed_ph, seed_energ.data(), seed_urad.data(), seed_energ.size());
 }
 
 //! Method to estimate the number of scatterings the electrons go through;
@@ -491,6 +502,7 @@ void Compton::seed_freq_array(const std::vector<double>& seed_arr) {
 //! calculated separately to see the contribution of each
 void Compton::reset() {
     std::fill(seed_urad.begin(), seed_urad.end(), 0);
+    std::fill(seed_field.begin(), seed_field.end(), 0);
     std::fill(seed_energ.begin(), seed_energ.end(), 0);
     std::fill(num_phot.begin(), num_phot.end(), 0);
     std::fill(num_phot_obs.begin(), num_phot_obs.end(), 0);
@@ -169,6 +169,7 @@ void Cyclosyn::cycsyn_spectrum(double gmin, double gmax, gsl_spline* eldis,
         emis = emis_integral(en_phot[k] / constants::herg, gmin, gmax, eldis, acc_eldis);
         abs = abs_integral(en_phot[k] / constants::herg, gmin, gmax, eldis_diff, acc_eldis_diff);
         if (std::log10(emis) < -50. || std::log10(abs) < -50.) {
+            num_phot[k] = 0;
             num_phot_obs[k] = 0;
             if (counterjet == true) {
                 num_phot_obs[k + size] = 0;
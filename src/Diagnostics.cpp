@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "kariba/Diagnostics.hpp"
+
+namespace kariba {
+
+void Diagnostics::Table::add_row(std::initializer_list<double> row) {
+    if (row.size() != widths.size()) {
+        std::cerr << "Diagnostics row of " << row.size() << " values for a table of "
+                  << widths.size() << " columns!" << std::endl;
+        exit(1);
+    }
+    values.insert(values.end(), row.begin(), row.end());
+}
+
+Diagnostics::Diagnostics() : format(Format::text) {}
+
+Diagnostics::~Diagnostics() { flush(); }
+
+Diagnostics::Table& Diagnostics::table(const std::string& path, const std::vector<int>& widths) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tables.try_emplace(path, widths).first->second;
+}
+
+const Diagnostics::Table* Diagnostics::find(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = tables.find(path);
+    return it == tables.end() ? nullptr : &it->second;
+}
+
+//! The text format is that of std::left << std::setw(width) << value, with
+//! the default precision, for every value of a row, and a newline per row
+void Diagnostics::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& [path, table] : tables) {
+        size_t ncols = table.get_ncolumns();
+        size_t nrows = table.get_nrows();
+        if (nrows == 0) {
+            continue;
+        }
+        if (format == Format::text) {
+            std::string text;
+            std::vector<char> buffer(64);
+            for (size_t i = 0; i < nrows; i++) {
+                for (size_t j = 0; j < ncols; j++) {
+                    int width = table.widths[j];
+                    double value = table.values[i * ncols + j];
+                    size_t n = static_cast<size_t>(
+                        std::snprintf(buffer.data(), buffer.size(), "%-*g", width, value));
+                    if (n >= buffer.size()) {    // a column wider than the buffer
+                        buffer.resize(n + 1);
+                        std::snprintf(buffer.data(), buffer.size(), "%-*g", width, value);
+                    }
+                    text.append(buffer.data(), n);
+                }
+                text += '\n';
+            }
+            std::ofstream file(path, std::ios::app);
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        } else {
+            std::ofstream file(path + ".bin", std::ios::app | std::ios::binary);
+            uint64_t shape[2] = {ncols, nrows};
+            file.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+            file.write(reinterpret_cast<const char*>(table.values.data()),
+                       static_cast<std::streamsize>(table.values.size() * sizeof(double)));
+        }
+        table.values.clear();
+    }
+}
+
+void Diagnostics::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : tables) {
+        entry.second.values.clear();
+    }
+}
+
+Diagnostics& diagnostics() {
+    static Diagnostics sink;
+    return sink;
+}
+
+}    // namespace kariba
@@ -1,6 +1,18 @@
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <gsl/gsl_spline2d.h>
 
@@ -1101,43 +1113,95 @@ struct {
         1.0000000e+10, 1.0000000e+10, 1.0000000e+10};
 } static LUT;
 
-// Internal function to provide the actual interpolation
-//
-// Performs a two-dimensional interpolation over the EBL table,
-// for the given redshift and set of input energies.
-static void interpolate(const std::vector<double>& en, std::vector<double>& lum, double redshift) {
+EBLTable::EBLTable(std::vector<double> redshift, std::vector<double> energy,
+                   std::vector<double> tau)
+    : redshift(std::move(redshift)), energy(std::move(energy)), tau(std::move(tau)) {
+    spline = gsl_spline2d_alloc(gsl_interp2d_bicubic, this->redshift.size(), this->energy.size());
+    gsl_spline2d_init(spline, this->redshift.data(), this->energy.data(), this->tau.data(),
+                      this->redshift.size(), this->energy.size());
+}
+
+EBLTable::~EBLTable() { gsl_spline2d_free(spline); }
+
+double EBLTable::eval(double z, double E, gsl_interp_accel* acc_z,
+                      gsl_interp_accel* acc_E) const {
+    return gsl_spline2d_eval(spline, z, E, acc_z, acc_E);
+}
+
+const EBLTable& gilmore_table() {
+    static const EBLTable table(std::vector<double>(LUT.redshift.begin(), LUT.redshift.end()),
+                                std::vector<double>(LUT.energy.begin(), LUT.energy.end()),
+                                std::vector<double>(LUT.ebl.begin(), LUT.ebl.end()));
+    return table;
+}
+
+EBLCurve::EBLCurve(const EBLTable& table, const std::vector<double>& en, double redshift)
+    : redshift(redshift), energy(en), attenuation(en.size(), 1.) {
+    const std::vector<double>& redshifts = table.get_redshift();
+    const std::vector<double>& energies = table.get_energy();
+    if (redshift < redshifts.front() || redshift > redshifts.back()) {
+        return;
+    }
     gsl_interp_accel* acc_TeV = gsl_interp_accel_alloc();
     gsl_interp_accel* acc_redshift = gsl_interp_accel_alloc();
-    gsl_spline2d* tau_gil =
-        gsl_spline2d_alloc(gsl_interp2d_bicubic, LUT.redshift.size(), LUT.energy.size());
-    gsl_spline2d_init(tau_gil, LUT.redshift.data(), LUT.energy.data(), LUT.ebl.data(),
-                      LUT.redshift.size(), LUT.energy.size());
-
-    bool has_min_lum = false;
     for (size_t k = 0; k < en.size(); k++) {
         double energy = en[k] * ERG_TO_TEV;
-        if (lum[k] < MIN_LUM) {
-            has_min_lum = true;
-            continue;
-        } else if (energy > LUT.energy.front() && energy < LUT.energy.back()) {
-            if (gsl_spline2d_eval(tau_gil, redshift, energy, acc_redshift, acc_TeV) >= 0.) {
-                lum[k] = lum[k] * std::exp(-1. * gsl_spline2d_eval(tau_gil, redshift, energy,
-                                                                   acc_redshift, acc_TeV));
+        if (energy > energies.front() && energy < energies.back()) {
+            double tau = table.eval(redshift, energy, acc_redshift, acc_TeV);
+            if (tau >= 0.) {
+                attenuation[k] = std::exp(-1. * tau);
             }
         }
     }
-    if (has_min_lum) {
-        std::cerr << "Some luminosities were below the threshold; no correction has been applied "
-                     "for those\n";
-    }
     gsl_interp_accel_free(acc_TeV);
     gsl_interp_accel_free(acc_redshift);
-    gsl_spline2d_free(tau_gil);
 }
 
-//! Define the function that does the EBL attenuation correction for the
-//! model by Gilmore et al. (2012)
-void ebl_atten_gil(const std::vector<double>& en, std::vector<double>& lum, double redshift) {
+// Attenuates one spectrum, and returns whether there were luminosities below
+// the threshold that were left as they are
+static bool attenuate(const double* attenuation, double* lum, size_t size) {
+    int has_min_lum = 0;
+#pragma omp simd reduction(| : has_min_lum)
+    for (size_t k = 0; k < size; k++) {
+        bool below = lum[k] < MIN_LUM;
+        has_min_lum |= below && attenuation[k] != 1.;
+        lum[k] = below ? lum[k] : lum[k] * attenuation[k];
+    }
+    return has_min_lum != 0;
+}
+
+static void warn_min_lum() {
+    std::cerr << "Some luminosities were below the threshold; no correction has been applied "
+                 "for those\n";
+}
+
+void EBLCurve::apply(std::vector<double>& lum) const {
+    if (attenuate(attenuation.data(), lum.data(), attenuation.size())) {
+        warn_min_lum();
+    }
+}
+
+void EBLCurve::apply(std::vector<double>& spectra, size_t nrows) const {
+    const size_t size = attenuation.size();
+    if (spectra.size() != nrows * size) {
+        std::cerr << "EBL attenuation of " << nrows << " spectra of " << size
+                  << " energies for an array of " << spectra.size() << " values!" << std::endl;
+        exit(1);
+    }
+    // Every spectrum is independent, and the curve is shared
+    int has_min_lum = 0;
+#pragma omp parallel for reduction(| : has_min_lum)
+    for (size_t i = 0; i < nrows; i++) {
+        has_min_lum |= attenuate(attenuation.data(), spectra.data() + i * size, size);
+    }
+    if (has_min_lum != 0) {
+        warn_min_lum();
+    }
+}
+
+// The redshift at which to evaluate the Gilmore model, with a warning when
+// it is outside the model
+static double gilmore_redshift(double redshift) {
     if (redshift < LUT.redshift.front()) {
         std::cerr << "Redshift is too small for EBL model (0.01 < redshift < "
                      "9.00). Using no attenuation.\n";
@@ -1145,10 +1209,189 @@ void ebl_atten_gil(const std::vector<double>& en, std::vector<double>& lum, doub
         std::cerr << "Redshift is too large for EBL model (0.01 < redshift < "
                      "9.00). Using attenuation for z = 9 instead.\n";
         // To do: replace with 1d spline interpolation over the energy only
-        interpolate(en, lum, 9);
-    } else {
-        interpolate(en, lum, redshift);
+        return 9;
+    }
+    return redshift;
+}
+
+// The registered models by name, with their table once loaded
+struct EBLModel {
+    std::string path;
+    std::shared_ptr<const EBLTable> table;
+};
+
+static std::mutex& models_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, EBLModel>& models() {
+    static std::map<std::string, EBLModel> models;
+    return models;
+}
+
+void register_ebl_model(const std::string& name, const std::string& path) {
+    if (name == "gilmore") {
+        std::cerr << "The EBL model gilmore is built in and can not be replaced!" << std::endl;
+        exit(1);
+    }
+    std::lock_guard<std::mutex> lock(models_mutex());
+    models()[name] = EBLModel{path, nullptr};
+}
+
+std::shared_ptr<const EBLTable> ebl_model(const std::string& name) {
+    if (name == "gilmore") {
+        // not owned, as the built-in table lives until the end of the program
+        return std::shared_ptr<const EBLTable>(std::shared_ptr<const EBLTable>(), &gilmore_table());
     }
+    std::lock_guard<std::mutex> lock(models_mutex());
+    auto it = models().find(name);
+    if (it == models().end()) {
+        std::cerr << "Unknown EBL model " << name << "!" << std::endl;
+        exit(1);
+    }
+    if (!it->second.table) {
+        it->second.table = read_ebl_table(it->second.path);
+    }
+    return it->second.table;
+}
+
+// FNV-1a hash of the contents of a table file
+static uint64_t checksum(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static const char EBL_MAGIC[4] = {'K', 'E', 'B', 'L'};
+static const uint32_t EBL_VERSION = 1;
+static const size_t EBL_HEADER = sizeof(EBL_MAGIC) + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+void write_ebl_table(const EBLTable& table, const std::string& path) {
+    const std::vector<double>& redshift = table.get_redshift();
+    const std::vector<double>& energy = table.get_energy();
+    const std::vector<double>& tau = table.get_tau();
+    uint64_t shape[2] = {redshift.size(), energy.size()};
+
+    std::string data(EBL_MAGIC, sizeof(EBL_MAGIC));
+    data.append(reinterpret_cast<const char*>(&EBL_VERSION), sizeof(EBL_VERSION));
+    data.append(reinterpret_cast<const char*>(shape), sizeof(shape));
+    for (const std::vector<double>* values : {&redshift, &energy, &tau}) {
+        data.append(reinterpret_cast<const char*>(values->data()),
+                    values->size() * sizeof(double));
+    }
+    uint64_t hash = checksum(data.data(), data.size());
+    data.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        std::cerr << "Can not write the EBL table " << path << "!" << std::endl;
+        exit(1);
+    }
+}
+
+std::shared_ptr<const EBLTable> read_ebl_table(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Can not read the EBL table " << path << "!" << std::endl;
+        exit(1);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint32_t version = 0;
+    uint64_t shape[2] = {0, 0};
+    if (data.size() >= EBL_HEADER) {
+        const char* header = data.data() + sizeof(EBL_MAGIC);
+        std::copy(header, header + sizeof(version), reinterpret_cast<char*>(&version));
+        std::copy(header + sizeof(version), header + sizeof(version) + sizeof(shape),
+                  reinterpret_cast<char*>(shape));
+    }
+    size_t nz = shape[0], ne = shape[1];
+    if (data.size() < EBL_HEADER || !std::equal(EBL_MAGIC, EBL_MAGIC + 4, data.begin()) ||
+        version != EBL_VERSION || nz < 4 || ne < 4 ||
+        data.size() != EBL_HEADER + (nz + ne + nz * ne) * sizeof(double) + sizeof(uint64_t)) {
+        std::cerr << path << " is not an EBL table!" << std::endl;
+        exit(1);
+    }
+    uint64_t hash;
+    size_t end = data.size() - sizeof(hash);
+    std::copy(data.data() + end, data.data() + data.size(), reinterpret_cast<char*>(&hash));
+    if (hash != checksum(data.data(), end)) {
+        std::cerr << "The checksum of the EBL table " << path << " does not match!" << std::endl;
+        exit(1);
+    }
+
+    std::vector<double> redshift(nz), energy(ne), tau(nz * ne);
+    const char* values = data.data() + EBL_HEADER;
+    for (std::vector<double>* v : {&redshift, &energy, &tau}) {
+        std::copy(values, values + v->size() * sizeof(double), reinterpret_cast<char*>(v->data()));
+        values += v->size() * sizeof(double);
+    }
+    return std::make_shared<const EBLTable>(std::move(redshift), std::move(energy),
+                                            std::move(tau));
+}
+
+// The redshift at which to evaluate a loaded model, with a warning when it
+// is outside the model, as for gilmore_redshift
+static double model_redshift(const EBLTable& table, double redshift) {
+    double zmin = table.get_redshift().front(), zmax = table.get_redshift().back();
+    if (redshift < zmin) {
+        std::cerr << "Redshift is too small for EBL model (" << zmin << " < redshift < " << zmax
+                  << "). Using no attenuation.\n";
+    } else if (redshift > zmax) {
+        std::cerr << "Redshift is too large for EBL model (" << zmin << " < redshift < " << zmax
+                  << "). Using attenuation for z = " << zmax << " instead.\n";
+        return zmax;
+    }
+    return redshift;
+}
+
+// A cached curve, with the table it was computed from
+struct CachedCurve {
+    std::shared_ptr<const EBLTable> table;
+    std::shared_ptr<const EBLCurve> curve;
+};
+
+//! Curves are cached by the table they were computed from rather than by the
+//! name of the model, so that a name registered again with another file gets
+//! new curves; the cache holds on to the tables, so that their addresses can
+//! not be reused while they are in it. The cache is emptied when it is full,
+//! rather than growing without bound when the redshift is a free parameter;
+//! curves still in use are kept alive by their shared pointers.
+std::shared_ptr<const EBLCurve> ebl_curve(const std::string& model, const std::vector<double>& en,
+                                          double redshift) {
+    static const size_t MAX_CURVES = 16;
+    static std::mutex mutex;
+    static std::map<std::tuple<const EBLTable*, double, std::vector<double>>, CachedCurve> curves;
+
+    std::shared_ptr<const EBLTable> table = ebl_model(model);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_tuple(table.get(), redshift, en);
+    auto it = curves.find(key);
+    if (it != curves.end()) {
+        return it->second.curve;
+    }
+    if (curves.size() >= MAX_CURVES) {
+        curves.clear();
+    }
+    double z = model == "gilmore" ? gilmore_redshift(redshift) : model_redshift(*table, redshift);
+    auto curve = std::make_shared<const EBLCurve>(*table, en, z);
+    curves.emplace(std::move(key), CachedCurve{table, curve});
+    return curve;
+}
+
+std::shared_ptr<const EBLCurve> gilmore_curve(const std::vector<double>& en, double redshift) {
+    return ebl_curve("gilmore", en, redshift);
+}
+
+//! Define the function that does the EBL attenuation correction for the
+//! model by Gilmore et al. (2012)
+void ebl_atten_gil(const std::vector<double>& en, std::vector<double>& lum, double redshift) {
+    EBLCurve(gilmore_table(), en, gilmore_redshift(redshift)).apply(lum);
 }
 
 }    // namespace kariba
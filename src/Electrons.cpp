@@ -11,15 +11,7 @@ namespace kariba {
 double multiplicity(double pspec) {
     // n tilde from Kelner et al. 2006. It is the number of produced pions for a
     // given proton distribution:
-    double ntilde;
-    if (pspec <= 2.25) {
-        ntilde = .77;
-    } else if (pspec >= 2.75) {
-        ntilde = .67;
-    } else {
-        ntilde = .62;
-    }
-    return ntilde;
+    return HadronicConstants::ntilde_leptons(pspec);
 }
 
 double prob() {
@@ -114,6 +106,20 @@ double elec_spec_pp(double Ep, double y) {
     return Fespec;
 }
 
+const PPDistributionTable& elec_dist_pp_table() {
+    static const PPDistributionTable table(&elec_dist_pp, pp_tables::lx_min, pp_tables::lx_max,
+                                           pp_tables::nx);
+    return table;
+}
+
+const PPKernelTable& elec_spec_pp_table() {
+    const size_t N = 60;
+    const double ymin = std::log10(1.e-3), ymax = std::log10(1.);
+    static const PPKernelTable table(&elec_spec_pp, pp_tables::lEp_min, pp_tables::lEp_max,
+                                     pp_tables::nEp, ymin, (ymax - ymin) / (N - 1), N);
+    return table;
+}
+
 //***********************************************************************************************************
 
 double production_rate(double ge, double x) {    // from Coppi & Blandford 1990
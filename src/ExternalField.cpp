@@ -0,0 +1,138 @@
+#include <cmath>
+
+#include <gsl/gsl_spline2d.h>
+
+#include "kariba/ExternalField.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+//! c(ζ)/(3β) for a region beyond the shell, ζ >= 1
+static double deboost(double zeta, double beta) {
+    double mu1 = std::pow(1. + std::pow(zeta, -2.), -1. / 2.);
+    double mu2 = std::pow(1. - std::pow(zeta, -2.), 1. / 2.);
+    double conv = 2. * std::pow(1. - beta * mu1, 3.) - std::pow(1. - beta * mu2, 3.) -
+                  std::pow(1. - beta, 3.);
+    return conv / (3. * beta);
+}
+
+double external_boost(double zeta, double gamma) {
+    double beta = std::sqrt((gamma * gamma - 1.) / (gamma * gamma));
+    if (zeta < 1.) {
+        return 1.;
+    } else if (zeta < 3.) {
+        return 1. + (zeta - 1.) / 2. * (deboost(3., beta) - 1.);
+    }
+    return deboost(zeta, beta);
+}
+
+ExternalBoostTable::ExternalBoostTable() {
+    const size_t nzeta = 227, ngamma = 101;
+    lzeta.resize(nzeta);
+    lgamma.resize(ngamma);
+    lboost.resize(nzeta * ngamma);
+    for (size_t i = 0; i < nzeta; i++) {
+        lzeta[i] = std::log10(3.) + 0.02 * static_cast<double>(i);
+    }
+    for (size_t j = 0; j < ngamma; j++) {
+        lgamma[j] = 0.01 + 0.025 * static_cast<double>(j);
+    }
+    for (size_t j = 0; j < ngamma; j++) {
+        double gamma = std::pow(10., lgamma[j]);
+        double beta = std::sqrt((gamma * gamma - 1.) / (gamma * gamma));
+        for (size_t i = 0; i < nzeta; i++) {
+            lboost[j * nzeta + i] = std::log10(deboost(std::pow(10., lzeta[i]), beta));
+        }
+    }
+    spline = gsl_spline2d_alloc(gsl_interp2d_bicubic, nzeta, ngamma);
+    gsl_spline2d_init(spline, lzeta.data(), lgamma.data(), lboost.data(), nzeta, ngamma);
+}
+
+ExternalBoostTable::~ExternalBoostTable() { gsl_spline2d_free(spline); }
+
+bool ExternalBoostTable::contains(double zeta, double gamma) const {
+    double lz = std::log10(zeta), lg = std::log10(gamma);
+    return lz >= lzeta.front() && lz <= lzeta.back() && lg >= lgamma.front() &&
+           lg <= lgamma.back();
+}
+
+double ExternalBoostTable::eval(double zeta, double gamma, gsl_interp_accel* acc_z,
+                                gsl_interp_accel* acc_g) const {
+    return std::pow(10., gsl_spline2d_eval(spline, std::log10(zeta), std::log10(gamma), acc_z,
+                                           acc_g));
+}
+
+const ExternalBoostTable& external_boost_table() {
+    static const ExternalBoostTable table;
+    return table;
+}
+
+//! The BLR radiates 12/17 of the energy density inside it, with the
+//! temperature of the Lyα photons
+void ExternalField::add_blr(double lum, double f) { add_stratified_blr(lum, f, 1, 1., 1.); }
+
+void ExternalField::add_stratified_blr(double lum, double f, size_t nshells, double rmin,
+                                       double rmax) {
+    double rblr = 1.e17 * std::pow(lum / 1.e45, 1. / 2.);
+    double temp = 10.2e-3 * constants::kboltz_kev2erg / constants::kboltz;
+    for (size_t i = 0; i < nshells; i++) {
+        double frac = nshells > 1 ? static_cast<double>(i) / static_cast<double>(nshells - 1) : 0.;
+        double radius = rblr * rmin * std::pow(rmax / rmin, frac);
+        double udens = (17. / 12.) * (f / static_cast<double>(nshells)) * lum /
+                       (4. * constants::pi * radius * radius * constants::cee);
+        double shell_lum =
+            (12. / 17.) * 4. * constants::pi * radius * radius * constants::cee * udens;
+        sources.push_back(Source{radius, udens, temp, shell_lum, 12. / 17.});
+    }
+}
+
+void ExternalField::add_torus(double lum, double f) {
+    double radius = 2.5e18 * std::pow(lum / 1.e45, 1. / 2.);
+    double udens = f * lum / (4. * constants::pi * radius * radius * constants::cee);
+    double torus_lum = 4. * constants::pi * radius * radius * constants::cee * udens;
+    sources.push_back(Source{radius, udens, 370., torus_lum, 1.});
+}
+
+//! The boost is looked up in the table beyond the source, and computed
+//! directly if the table does not cover the region
+double ExternalField::comoving_udens(size_t k, double z, double gamma, double delta,
+                                     gsl_interp_accel* acc_z, gsl_interp_accel* acc_g) const {
+    const Source& source = sources[k];
+    const ExternalBoostTable& table = external_boost_table();
+    double zeta = z / source.radius;
+    double boost;
+    if (zeta < 1.) {
+        boost = 1.;
+    } else if (zeta < 3. && table.contains(3., gamma)) {
+        boost = 1. + (zeta - 1.) / 2. * (table.eval(3., gamma, acc_z, acc_g) - 1.);
+    } else if (zeta >= 3. && table.contains(zeta, gamma)) {
+        boost = table.eval(zeta, gamma, acc_z, acc_g);
+    } else {
+        boost = external_boost(zeta, gamma);
+    }
+    return delta * delta * source.udens * boost;
+}
+
+//! Inside a source and in the transition beyond it the cooling takes the
+//! energy density boosted by Γ^2 and Γ^2/δ^2, and further out only the
+//! fraction fcooling of the comoving one, as in Ghisellini & Tavecchio 2009
+double ExternalField::cooling_udens(double z, double gamma, double delta,
+                                    gsl_interp_accel* acc_z, gsl_interp_accel* acc_g) const {
+    double sum = 0.;
+    for (size_t k = 0; k < sources.size(); k++) {
+        const Source& source = sources[k];
+        double zeta = z / source.radius;
+        if (zeta < 1.) {
+            sum += gamma * gamma * source.udens;
+        } else if (zeta < 3.) {
+            sum += gamma * gamma * comoving_udens(k, z, gamma, delta, acc_z, acc_g) *
+                   std::pow(gamma / delta, 2.);
+        } else {
+            sum += gamma * gamma * source.fcooling *
+                   comoving_udens(k, z, gamma, delta, acc_z, acc_g) / (delta * delta);
+        }
+    }
+    return sum;
+}
+
+}    // namespace kariba
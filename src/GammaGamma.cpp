@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+
+#include "kariba/Electrons.hpp"
+#include "kariba/GammaGamma.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+GammaGamma::GammaGamma(double gmin, double gmax, size_t ngamma,
+                       const std::vector<double>& en_phot)
+    : gamma(ngamma), energy(en_phot) {
+    size_t nphot = energy.size();
+    std::vector<double> x(nphot), logx(nphot), dE(nphot);
+    double dx = std::log10(energy[2] / energy[1]);
+    for (size_t k = 0; k < nphot; k++) {
+        x[k] = energy[k] / constants::emerg;
+        logx[k] = std::log10(x[k]);
+        dE[k] = constants::emerg * x[k] * std::log(10.) * dx;    // log integration
+    }
+
+    pair_rates.resize(ngamma * nphot);
+    index.resize(ngamma);
+    weight.resize(ngamma);
+    for (size_t i = 0; i < ngamma; i++) {
+        gamma[i] =
+            std::pow(10., std::log10(gmin) + static_cast<double>(i) * std::log10(gmax / gmin) /
+                                                 static_cast<double>(ngamma - 1));
+        for (size_t k = 0; k < nphot; k++) {
+            pair_rates[i * nphot + k] = production_rate(gamma[i], x[k]) * dE[k];
+        }
+
+        double Eg = std::log10(2. * gamma[i]);    // 2γ from MK95
+        if (Eg < logx[0] || Eg > logx[nphot - 1]) {
+            index[i] = nphot;
+            weight[i] = 0.;
+        } else {
+            size_t k = static_cast<size_t>(std::upper_bound(logx.begin(), logx.end(), Eg) -
+                                           logx.begin());
+            k = std::min(k == 0 ? 0 : k - 1, nphot - 2);
+            index[i] = k;
+            weight[i] = (Eg - logx[k]) / (logx[k + 1] - logx[k]);
+        }
+    }
+
+    photon_rates.resize(nphot * nphot);
+    for (size_t j = 0; j < nphot; j++) {
+        for (size_t k = 0; k < nphot; k++) {
+            // production_rate(ge, x) is the rate for photons 2ge and x
+            photon_rates[j * nphot + k] = production_rate(x[j] / 2., x[k]) * dE[k];
+        }
+    }
+}
+
+void GammaGamma::opacity(const std::vector<double>& n, double r, std::vector<double>& tau) const {
+    size_t nphot = energy.size();
+    tau.resize(nphot);
+    for (size_t j = 0; j < nphot; j++) {
+        const double* rates = &photon_rates[j * nphot];
+        double sum = 0.;
+        for (size_t k = 0; k < nphot; k++) {
+            sum += rates[k] * n[k];
+        }
+        tau[j] = sum * r / constants::cee;
+    }
+}
+
+void GammaGamma::pair_injection(const std::vector<double>& n, std::vector<double>& Q) const {
+    size_t nphot = energy.size();
+    Q.resize(gamma.size());
+    for (size_t i = 0; i < gamma.size(); i++) {
+        size_t k = index[i];
+        if (k == nphot) {
+            Q[i] = 1.e-200;
+            continue;
+        }
+        // n_γ(2γ), interpolated linearly in log-log if possible
+        double w = weight[i];
+        double ng;
+        if (n[k] > 0. && n[k + 1] > 0.) {
+            ng = std::exp((1. - w) * std::log(n[k]) + w * std::log(n[k + 1]));
+        } else {
+            ng = (1. - w) * n[k] + w * n[k + 1];
+        }
+
+        const double* rates = &pair_rates[i * nphot];
+        double sum = 0.;
+        for (size_t l = 0; l < nphot; l++) {    // eq. 57 from MK95
+            sum += rates[l] * n[l];
+        }
+        Q[i] = 4. * ng * sum;
+    }
+}
+
+}    // namespace kariba
@@ -8,6 +8,7 @@ Gamma-rays from neutral pion decay, products of inelastic pp and pγ collisions
 #include <gsl/gsl_integration.h>
 
 #include "kariba/GammaRays.hpp"
+#include "kariba/Photomeson.hpp"
 #include "kariba/constants.hpp"
 
 namespace kariba {
@@ -43,39 +44,29 @@ Grays::Grays(size_t size, double numin, double numax) : Radiation(size) {
 
 //************************************************************************************************************
 void Grays::set_grays_pp(double p, double gammap_min, double gammap_max, double ntot_prot,
-                         double ntargets, double plfrac, gsl_interp_accel* acc_Jp,
+                         double ntargets, double plfrac, gsl_interp_accel* /*acc_Jp*/,
                          gsl_spline* spline_Jp) {
-
-    double ntilde =
-        set_ntilde(p);    // The number of produced pions for a given proton distribution
-    double pp_targets = target_protons(ntot_prot, ntargets, plfrac);
     double Epcode_max = gammap_max * constants::pmgm * constants::cee * constants::cee *
                         constants::erg * 1.0e-12;    // The proton energy in TeV
+    set_grays_pp(p, ntot_prot, ntargets, plfrac,
+                 PPCollisionRate(gammap_min, Epcode_max, spline_Jp));
+}
+
+void Grays::set_grays_pp(double p, double ntot_prot, double ntargets, double plfrac,
+                         const PPCollisionRate& rate, const HadronicConstants& hadronic) {
+
+    double ntilde = hadronic.ntilde_grays(p);    // The number of produced pions for
+                                                 // a given proton distribution
+    double pp_targets = target_protons(ntot_prot, ntargets, plfrac);
+    double Epcode_max = rate.get_Epcode_max();    // The proton energy in TeV
 
-    int N = 60;                        // The number of steps of the secondary particle (e.g., pion)
+    const int N = 60;                  // The number of steps of the secondary particle (e.g., pion)
                                        // energy.
-    double Ep;                         // The energy of the proton in TeV
-    double Eg;                         // The energy of the gamma-ray photon in TeV
-    double Jp;                         // The number of non-thermal protons/cm3/TeV
     double xmin = 1.e-3, xmax = 1.;    // The min/max energy of product as a
                                        // function of proton energy.
-    double ymin, ymax, dy, y;          // The exponent of the above
-    double Epimin, Epimax;             // Min/Max pion energy in TeV for the integral
-                                       // over all pion energies.
-    double dw, w;                      // exponent of the above
-    double sinel;                      // The inelastic part of the total cross-section of pp
-                                       // collisions.
-    double qpi;                        // The production rate of pions.
-    double Fpi;           /* The integrated quantity from eq. 78 from Kelner et al. 2006,
-                             namely, the emissivity of electrons for one particular pion
-                             energy.*/
-    double sum;           // For the integral over all pion energies.
-    double Phig;          /* Φ_gamma the energy spectral distribution in #/cm3/TeV/sec
-                             for   gamma-rays produced by neutral pion decay.	*/
-    double Fg;            // Spectrum of γ rays from pion decay. Eq 58 from Kelner et
-                          // al. 2006
-    double transition;    // The transition between delta approximation and
-                          // distributions in TeV
+    double ymin, ymax, dy;             // The exponent of the above
+    double transition;                 // The transition between delta approximation and
+                                       // distributions in TeV
 
     double dopfac_cj;
     dopfac_cj = dopfac * (1. - beta * cos(angle)) / (1. + beta * cos(angle));
@@ -87,44 +78,52 @@ void Grays::set_grays_pp(double p, double gammap_min, double gammap_max, double
     transition = 0.10;    // The transition between delta approximation and
                           // distributions.
 
-    size_t size = en_phot.size();
+    const PPKernelTable& gspec_table = gspec_pp_table();
+
+    // Every photon energy is independent, and σ_pp Jp is a shared table
+    const size_t size = en_phot.size();
+#pragma omp parallel for schedule(dynamic)
     for (size_t j = 0; j < size; j++) {
-        Eg = en_phot[j] * 1.0e-12 * constants::erg;
+        double Eg = en_phot[j] * 1.0e-12 * constants::erg;    // gamma-ray energy in TeV
+        double sum = 0.;    // For the integral over all pion energies.
+        double Phig;        /* Φ_gamma the energy spectral distribution in #/cm3/TeV/sec
+                               for   gamma-rays produced by neutral pion decay.	*/
         if (Eg < transition) {    // Delta approximation for distribution
-            Epimin = Eg + constants::mpionTeV * constants::mpionTeV /
-                              (4. * Eg);    // The min pion energy in TeV for the integral
-            Epimax = 1.e6;                  // The max pion energy in Tev for the integral
-            dw = std::log10(Epimax / Epimin) / (N - 1);    // The logarithmic step with which the
-                                                           // pion energy increases.
-            sum = 0.;
-            for (int i = 1; i < N; i++) {    // I am using 1 instead of 0 because I get a weird
-                                             // spine otherwise
-                                             // at x~10^-4 (production of particles from protons
-                                             // with total energy less than the rest mass --
-                                             // impossible)
-                w = std::log10(Epimin) + i * dw;
-                Ep = constants::mprotTeV + std::pow(10., w) / constants::Kpi;
-                sinel = sigma_pp(Ep);
-                Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                qpi = 2. * ntilde / constants::Kpi * sinel *
-                      Jp;    // The production rate of neutral pions
-                Fpi = qpi * std::pow(10., w) /
-                      sqrt(std::pow(10., (2. * w)) -
-                           constants::mpionTeV * constants::mpionTeV);    // eq 78 in Kelner+2006
+            double Epimin =
+                Eg + constants::mpionTeV * constants::mpionTeV /
+                         (4. * Eg);    // The min pion energy in TeV for the integral
+            double Epimax = 1.e6;      // The max pion energy in Tev for the integral
+            double dw = std::log10(Epimax / Epimin) / (N - 1);    // The logarithmic step with
+                                                                  // which the pion energy
+                                                                  // increases.
+            double lEpimin = std::log10(Epimin);
+            // I am using 1 instead of 0 because I get a weird spine otherwise at x~10^-4
+            // (production of particles from protons with total energy less than the rest mass
+            // -- impossible)
+            for (int i = 1; i < N; i++) {
+                double w = lEpimin + i * dw;
+                double Ep = constants::mprotTeV + std::pow(10., w) / constants::Kpi;
+                double qpi = 2. * ntilde / constants::Kpi *
+                             rate.eval(Ep, std::log10(Ep));    // The production rate of neutral
+                                                               // pions
+                double Fpi = qpi * std::pow(10., w) /
+                             sqrt(std::pow(10., (2. * w)) -
+                                  constants::mpionTeV * constants::mpionTeV);    // eq 78 in
+                                                                                 // Kelner+2006
                 sum += dw * Fpi;
             }
             Phig = constants::cee * pp_targets * sum * constants::mbarn *
                    std::log(10.);    // dNg/dEg in #/TeV/cm3/sec
         } else if ((Eg > transition) && (Eg <= Epcode_max)) {
-            sum = 0.;
+            double lEg = std::log10(Eg);
             for (int i = 1; i < N; i++) {
-                y = ymin + (i - 1) * dy;
-                Ep = std::pow(10., (std::log10(Eg) - y));
+                double y = ymin + (i - 1) * dy;
+                double lEp = lEg - y;
+                double Ep = std::pow(10., lEp);
                 if ((Ep >= 0.1) && (Ep <= Epcode_max)) {
-                    sinel = sigma_pp(Ep);
-                    Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                    Fg = gspec_pp(Ep, y);
-                    sum += dy * (sinel * Jp * Fg);
+                    // Spectrum of γ rays from pion decay. Eq 58 from Kelner et al. 2006
+                    double Fg = gspec_table.eval(lEp, y);
+                    sum += dy * (rate.eval(Ep, lEp) * Fg);
                 }
             }
             Phig = constants::cee * pp_targets * sum * constants::mbarn *
@@ -152,15 +151,7 @@ void Grays::set_grays_pp(double p, double gammap_min, double gammap_max, double
 double set_ntilde(double p) {
     // n tilde from Kelner et al. 2006. It is the number of produced pions for a
     // given proton distribution:
-    double ntilde;
-    if (p <= 2.25) {
-        ntilde = 1.10;
-    } else if (p >= 2.75) {
-        ntilde = 0.86;
-    } else {
-        ntilde = 0.91;
-    }
-    return ntilde;
+    return HadronicConstants::ntilde_grays(p);
 }
 
 double target_protons(double ntot_prot, double ntargets, double plfrac) {
@@ -231,155 +222,125 @@ double gspec_pp(double Ep, double y) {
     return Fg;
 }
 
+const PPKernelTable& gspec_pp_table() {
+    const int N = 60;
+    const double ymin = std::log10(1.e-3), ymax = std::log10(1.);
+    static const PPKernelTable table(&gspec_pp, pp_tables::lEp_min, pp_tables::lEp_max,
+                                     pp_tables::nEp, ymin, (ymax - ymin) / (N - 1), N - 1);
+    return table;
+}
+
 //************************************************************************************************************
 void sum_photons(size_t nphot, std::vector<double>& en_perseg, std::vector<double>& lum_perseg,
                  size_t ntarg, const std::vector<double>& targ_en,
                  const std::vector<double>& targ_lum) {
-
-    std::vector<double> lx(ntarg, 0.0);    // std::log10 of targ_en[]/emerg
-    std::vector<double> lL(ntarg, 0.0);    // std::log10 of Luminosity of targets in erg/s/Hz
-
-    double logx;
-
-    for (size_t i = 0; i < ntarg;
-         i++) {    // lx = std::log10(hv/mec2) of target photons with energy hv
-        lx[i] = std::log10(targ_en[i] / constants::emerg);
-        if (targ_lum[i] == 0.) {
-            lL[i] = -100.;
-        } else {
-            lL[i] = std::log10(targ_lum[i]);
-        }
-    }
-
-    // We interpolate over the targets
-    gsl_interp_accel* acc_targ = gsl_interp_accel_alloc();
-    gsl_spline* spline_targ = gsl_spline_alloc(gsl_interp_akima, ntarg);
-    gsl_spline_init(spline_targ, lx.data(), lL.data(), ntarg);
-
-    for (size_t i = 0; i < nphot; i++) {
-        logx = std::log10(en_perseg[i] / constants::emerg);
-        if (logx >= lx[0] && logx <= lx[ntarg - 5]) {
-            lum_perseg[i] +=
-                std::max(1.e-200, std::pow(10., gsl_spline_eval(spline_targ, logx, acc_targ)));
-        }
-    }
-
-    gsl_spline_free(spline_targ), gsl_interp_accel_free(acc_targ);
+    TargetSpectrum target(ntarg);
+    target.set_spectrum(targ_en, targ_lum);
+    target.add(en_perseg, lum_perseg, nphot);
 }
 
 void sum_photons(size_t nphot, const std::vector<double>& en_perseg,
                  std::vector<double>& lum_perseg, size_t ntarg, const std::vector<double>& targ_en,
                  const std::vector<double>& targ_lum) {
-
-    std::vector<double> lx(ntarg, 0.0);    // std::log10 of targ_en[]/emerg
-    std::vector<double> lL(ntarg, 0.0);    // std::log10 of Luminosity of targets in erg/s/Hz
-
-    double logx;
-
-    for (size_t i = 0; i < ntarg;
-         i++) {    // lx = std::log10(hv/mec2) of target photons with energy hv
-        lx[i] = std::log10(targ_en[i] / constants::emerg);
-        if (targ_lum[i] == 0.) {
-            lL[i] = -100.;
-        } else {
-            lL[i] = std::log10(targ_lum[i]);
-        }
-    }
-
-    // We interpolate over the targets
-    gsl_interp_accel* acc_targ = gsl_interp_accel_alloc();
-    gsl_spline* spline_targ = gsl_spline_alloc(gsl_interp_akima, ntarg);
-    gsl_spline_init(spline_targ, lx.data(), lL.data(), ntarg);
-
-    for (size_t i = 0; i < nphot; i++) {
-        logx = std::log10(en_perseg[i] / constants::emerg);
-        if (logx >= lx[0] && logx <= lx[ntarg - 5]) {
-            lum_perseg[i] +=
-                std::max(1.e-200, std::pow(10., gsl_spline_eval(spline_targ, logx, acc_targ)));
-        }
-    }
-
-    gsl_spline_free(spline_targ), gsl_interp_accel_free(acc_targ);
+    TargetSpectrum target(ntarg);
+    target.set_spectrum(targ_en, targ_lum);
+    target.add(en_perseg, lum_perseg, nphot);
 }
 
 //************************************************************************************************************
-void Grays::set_grays_pg(double gp_min, double gp_max, gsl_interp_accel* acc_Jp,
+void Grays::set_grays_pg(double gp_min, double gp_max, gsl_interp_accel* /*acc_Jp*/,
                          gsl_spline* spline_Jp, std::vector<double>& en_perseg,
                          std::vector<double>& lum_perseg, size_t nphot) {
+    PhotonField field(nphot);
+    field.set_field(en_perseg, lum_perseg, r, vol);
+    set_grays_pg(gp_min, gp_max, spline_Jp, field);
+}
+
+void Grays::set_grays_pg(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                         const PhotonField& field) {
 
     size_t N = 10;
     double mpion =
         137.5e6 / constants::erg / (constants::cee * constants::cee);    // mass of pion in g
-    double eta, deta;           // eta parameter: η = 4εE_p/(m_p^2*c^4) and its step
+    double deta;                // step of η = 4εE_p/(m_p^2*c^4)
     double eta_zero = 0.313;    // eq 16 from Kelner & Aharonian 08
-    double Hg;                  // the quantity that we intergrate for every eta
-    double dNdEg;               // spectrum of gamma-rays in #/erg/cm3/sec
     double eta_max = 99.99;     // max η
     double eta_min = 1.10;      // min η
-    double nu_min = en_perseg[0] / constants::herg;            // the min freq of photon targets
-    double nu_max = en_perseg[nphot - 1] / constants::herg;    // the max freq of photon targets
-    std::vector<double> freq(nphot, 0.0);     // frequency of photons per segment in Hz
-    std::vector<double> Uphot(nphot, 0.0);    // diff energy density per segment in #/cm3/erg
+    double nu_min = field.get_numin();    // the min freq of photon targets
+    double nu_max = field.get_numax();    // the max freq of photon targets
+    gsl_spline* spline_ng = field.get_spline();
 
     double dopfac_cj;
     dopfac_cj = dopfac * (1. - beta * cos(angle)) / (1. + beta * cos(angle));
 
-    for (size_t k = 0; k < nphot; k++) {
-        freq[k] = en_perseg[k] / constants::herg;    // Hz from erg
-        Uphot[k] =
-            lum_perseg[k] * (r / constants::cee /
-                             (constants::herg * constants::herg * freq[k] * vol));    // #/cm3/erg
-    }
+    deta = std::log10(eta_max / eta_min) / static_cast<double>(N - 1);
 
-    // Interpolation for jet photon distribution
-    gsl_interp_accel* acc_ng = gsl_interp_accel_alloc();
-    gsl_spline* spline_ng = gsl_spline_alloc(gsl_interp_akima, nphot);
-    gsl_spline_init(spline_ng, freq.data(), Uphot.data(), nphot);
+    // The η nodes, and the spectrum parameters at each node, are the same for
+    // every γ-ray energy
+    std::vector<double> eta_nodes(N), s_nodes(N), delta_nodes(N), Beta_nodes(N);
+    for (size_t j = 0; j < N; j++) {
+        eta_nodes[j] =
+            eta_zero * (std::pow(10., std::log10(eta_min) + static_cast<double>(j) * deta));
+        tables_photomeson_gamma(s_nodes[j], delta_nodes[j], Beta_nodes[j],
+                                eta_nodes[j] / eta_zero);
+    }
 
-    deta = std::log10(eta_max / eta_min) / static_cast<double>(N - 1);
     size_t size = en_phot.size();
-#pragma omp parallel for private(eta, Hg, dNdEg)    // possibly lost: 9,424 bytes in 31 blocks
-    for (size_t i = 0; i < size; i++) {             // for every produced γ ray energy
-        double Eg = en_phot[i];                     // in erg
-        if (Eg > mpion * constants::cee * constants::cee) {
-            double sum = 0.0;
-            gsl_integration_workspace* w1 = gsl_integration_workspace_alloc(100);
-            double result1, error1;
-            gsl_function F1;
-            for (size_t j = 0; j < N; j++) {
-                eta =
-                    eta_zero * (std::pow(10., std::log10(eta_min) + static_cast<double>(j) * deta));
-                auto F1params = HetagParams{eta,    eta_zero,  Eg,     gp_min,
-                                            gp_max, spline_Jp, acc_Jp,    // product,
-                                            acc_ng, spline_ng, nu_min, nu_max};
-                F1.function = &Hetag;
-                F1.params = &F1params;
-                double max =
-                    std::log10(Eg / (gp_min * constants::pmgm * constants::cee * constants::cee));
-                double min =
-                    std::log10(Eg / (gp_max * constants::pmgm * constants::cee * constants::cee));
-                gsl_integration_qag(&F1, min, max, 1e0, 1e0, 100, 1, w1, &result1, &error1);
-                Hg = std::pow(constants::pmgm * constants::cee * constants::cee, 2) / 4. * result1;
-                sum += Hg * deta * eta *
-                       std::log(10.);    // todo: replace std::log(10) with std::M_LN10
+    // Every thread has its own interpolation accelerators and integration
+    // workspace; the splines are only read. Each energy bin is computed by a
+    // single thread, so the result does not depend on the number of threads.
+#pragma omp parallel
+    {
+        gsl_interp_accel* acc_Jp_thread = gsl_interp_accel_alloc();
+        gsl_interp_accel* acc_ng_thread = gsl_interp_accel_alloc();
+        gsl_integration_workspace* w1 = gsl_integration_workspace_alloc(100);
+
+#pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < size; i++) {    // for every produced γ ray energy
+            double dNdEg;
+            double Eg = en_phot[i];    // in erg
+            if (Eg > mpion * constants::cee * constants::cee) {
+                double sum = 0.0;
+                double result1, error1;
+                gsl_function F1;
+                for (size_t j = 0; j < N; j++) {
+                    double eta = eta_nodes[j];
+                    auto F1params = HetagParams{eta,           eta_zero,       Eg,
+                                                gp_min,        gp_max,         spline_Jp,
+                                                acc_Jp_thread, acc_ng_thread,  spline_ng,
+                                                nu_min,        nu_max,         s_nodes[j],
+                                                delta_nodes[j], Beta_nodes[j]};
+                    F1.function = &Hetag;
+                    F1.params = &F1params;
+                    double max = std::log10(
+                        Eg / (gp_min * constants::pmgm * constants::cee * constants::cee));
+                    double min = std::log10(
+                        Eg / (gp_max * constants::pmgm * constants::cee * constants::cee));
+                    gsl_integration_qag(&F1, min, max, 1e0, 1e0, 100, 1, w1, &result1, &error1);
+                    double Hg =
+                        std::pow(constants::pmgm * constants::cee * constants::cee, 2) / 4. *
+                        result1;
+                    sum += Hg * deta * eta *
+                           std::log(10.);    // todo: replace std::log(10) with std::M_LN10
+                }
+                dNdEg = sum;    // in #/erg/cm3/sec
+            } else {
+                dNdEg = 1.e-100;    // in #/erg/cm3/sec
             }
-            dNdEg = sum;    // in #/erg/cm3/sec
-            gsl_integration_workspace_free(w1);
-        } else {
-            dNdEg = 1.e-100;    // in #/erg/cm3/sec
-        }
 
-        num_phot[i] = dNdEg * constants::herg * en_phot[i] * vol;    // erg/sec/Hz
-        en_phot_obs[i] = en_phot[i] * dopfac;
-        num_phot_obs[i] = num_phot[i] * std::pow(dopfac, dopnum);    // L'_v' -> L_v
-        if (counterjet == true) {
-            en_phot_obs[i + size] = en_phot[i] * dopfac_cj;
-            num_phot_obs[i + size] = num_phot[i] * std::pow(dopfac_cj, dopnum);
+            num_phot[i] = dNdEg * constants::herg * en_phot[i] * vol;    // erg/sec/Hz
+            en_phot_obs[i] = en_phot[i] * dopfac;
+            num_phot_obs[i] = num_phot[i] * std::pow(dopfac, dopnum);    // L'_v' -> L_v
+            if (counterjet == true) {
+                en_phot_obs[i + size] = en_phot[i] * dopfac_cj;
+                num_phot_obs[i + size] = num_phot[i] * std::pow(dopfac_cj, dopnum);
+            }
         }
-    }
 
-    gsl_spline_free(spline_ng);
-    gsl_interp_accel_free(acc_ng);
+        gsl_integration_workspace_free(w1);
+        gsl_interp_accel_free(acc_ng_thread);
+        gsl_interp_accel_free(acc_Jp_thread);
+    }
 }
 
 double Hetag(double x, void* pars) {
@@ -396,6 +357,9 @@ double Hetag(double x, void* pars) {
     gsl_spline* spline_ng = params->spline_ng;
     double nu_min = params->nu_min;
     double nu_max = params->nu_max;
+    double s = params->s;
+    double delta = params->delta;
+    double Beta = params->Beta;
 
     double fp;         // number density of accelerated protons in #/cm3/erg
     double fph;        // number density of target photons in #/cm3/Hz
@@ -408,7 +372,7 @@ double Hetag(double x, void* pars) {
     fph_jet = photons_jet(eta, Ep, spline_ng, acc_ng, nu_min, nu_max);
     fph = fph_jet;    // all the target photons are now included into the
                       // fph_jet function
-    Phig = PhiFunc_gamma(eta, eta_zero, std::pow(10., x));
+    Phig = PhiFunc_gamma(eta, eta_zero, std::pow(10., x), s, delta, Beta);
     return fp * fph * Phig * std::log(10.) / Eg;
 }
 
@@ -446,17 +410,18 @@ double photons_jet(double eta, double Ep, gsl_spline* spline_ng, gsl_interp_acce
 }
 
 double PhiFunc_gamma(double eta, double eta0, double x) {
+    double s, delta, Beta;    // the parameters for spectrum
+    tables_photomeson_gamma(s, delta, Beta, eta / eta0);
+    return PhiFunc_gamma(eta, eta0, x, s, delta, Beta);
+}
+
+double PhiFunc_gamma(double eta, double eta0, double x, double s, double delta, double Beta) {
     // eqs 27,28,29 etc for gamma rays with interpolation in the tables given by
     // KA08 and eqs 31,32,33,34,35,36,37,38,39,40,41 and tables for leptons
 
-    double Phi;                  // spectrum of products
-    double xminus, xplus;        // eq. 19 from KA08 for min/max energy of pion
-    double r = 0.146;            // mpion/mproton = 0.146 for above expressions
-    double s, delta, Beta;       // the parameters for spectrum
-    double xeta = eta / eta0;    // x_eta to distinguish from x = Ep/Ei -- it's
-                                 // ρ sometimes in KA08
-
-    tables_photomeson_gamma(s, delta, Beta, xeta);
+    double Phi;              // spectrum of products
+    double xminus, xplus;    // eq. 19 from KA08 for min/max energy of pion
+    double r = 0.146;        // mpion/mproton = 0.146 for above expressions
 
     xplus = 1. / (2. + 2. * eta) *
             (eta + r * r + sqrt((eta - r * r - 2. * r) * (eta - r * r + 2. * r)));
@@ -479,25 +444,9 @@ double PhiFunc_gamma(double eta, double eta0, double x) {
 //! The tables from KA08 for photomeson that give s,δ and B
 void tables_photomeson_gamma(double& s, double& delta, double& Beta, double xeta) {
     // Gamma rays from neutral pion decay:
-    size_t size = etagTable.size();
-    gsl_interp_accel* acc_sigma = gsl_interp_accel_alloc();
-    gsl_spline* spline_sigma = gsl_spline_alloc(gsl_interp_cspline, size);
-    gsl_interp_accel* acc_delta = gsl_interp_accel_alloc();
-    gsl_spline* spline_delta = gsl_spline_alloc(gsl_interp_cspline, size);
-    gsl_interp_accel* acc_Beta = gsl_interp_accel_alloc();
-    gsl_spline* spline_Beta = gsl_spline_alloc(gsl_interp_cspline, size);
-
-    gsl_spline_init(spline_sigma, etagTable.data(), sgTable.data(), size);
-    gsl_spline_init(spline_delta, etagTable.data(), deltagTable.data(), size);
-    gsl_spline_init(spline_Beta, etagTable.data(), BetagTable.data(), size);
-
-    s = gsl_spline_eval(spline_sigma, xeta, acc_sigma);
-    delta = gsl_spline_eval(spline_delta, xeta, acc_delta);
-    Beta = gsl_spline_eval(spline_Beta, xeta, acc_Beta);
-
-    gsl_spline_free(spline_sigma), gsl_interp_accel_free(acc_sigma);
-    gsl_spline_free(spline_delta), gsl_interp_accel_free(acc_delta);
-    gsl_spline_free(spline_Beta), gsl_interp_accel_free(acc_Beta);
+    static const PhotomesonTable table(etagTable.data(), sgTable.data(), deltagTable.data(),
+                                       BetagTable.data(), etagTable.size());
+    table.eval(xeta, s, delta, Beta);
 }
 
 }    // namespace kariba
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "kariba/Integration.hpp"
+
+namespace kariba {
+
+// Abscissae and weights of the 15-point Kronrod rule and the embedded 7-point
+// Gauss rule, as in QUADPACK and GSL. The last Kronrod abscissa is the centre.
+static const std::array<double, 8> xgk = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000};
+static const std::array<double, 4> wg = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+static const std::array<double, 8> wgk = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+
+static const double dbl_epsilon = std::numeric_limits<double>::epsilon();
+static const double dbl_min = std::numeric_limits<double>::min();
+
+//! The error estimate of the Gauss-Kronrod rule, as in QUADPACK
+static double rescale_error(double err, double result_abs, double result_asc) {
+    err = std::fabs(err);
+    if (result_asc != 0 && err != 0) {
+        double scale = std::pow((200 * err / result_asc), 1.5);
+        if (scale < 1) {
+            err = result_asc * scale;
+        } else {
+            err = result_asc;
+        }
+    }
+    if (result_abs > dbl_min / (50 * dbl_epsilon)) {
+        double min_err = 50 * dbl_epsilon * result_abs;
+        if (min_err > err) {
+            err = min_err;
+        }
+    }
+    return err;
+}
+
+static bool subinterval_too_small(double a1, double a2, double b2) {
+    double tmp = (1 + 100 * dbl_epsilon) * (std::fabs(a2) + 1000 * dbl_min);
+    return std::fabs(a1) <= tmp && std::fabs(b2) <= tmp;
+}
+
+VectorQag::VectorQag(size_t nvalues, size_t limit)
+    : nvalues(nvalues), limit(limit), alist(limit), blist(limit), rlist(limit * nvalues),
+      elist(limit * nvalues), fcenter(nvalues), fv1(7 * nvalues), fv2(7 * nvalues),
+      resabs(nvalues), resasc(nvalues), resasc1(nvalues), area1(nvalues), area2(nvalues),
+      error1(nvalues), error2(nvalues), area(nvalues), errsum(nvalues), tolerance(nvalues),
+      roundoff_type1(nvalues), roundoff_type2(nvalues) {}
+
+void VectorQag::qk15(VectorFunction f, void* params, size_t n, double a, double b,
+                     double* result, double* abserr) {
+    const double center = 0.5 * (a + b);
+    const double half_length = 0.5 * (b - a);
+    const double abs_half_length = std::fabs(half_length);
+
+    f(center, fcenter.data(), params);
+    for (size_t j = 0; j < 7; j++) {
+        const double abscissa = half_length * xgk[j];
+        f(center - abscissa, &fv1[j * nvalues], params);
+        f(center + abscissa, &fv2[j * nvalues], params);
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        double result_gauss = fcenter[k] * wg[3];
+        double result_kronrod = fcenter[k] * wgk[7];
+        double result_abs = std::fabs(result_kronrod);
+        for (size_t j = 0; j < 3; j++) {
+            const size_t jtw = j * 2 + 1;
+            const double fval1 = fv1[jtw * nvalues + k];
+            const double fval2 = fv2[jtw * nvalues + k];
+            const double fsum = fval1 + fval2;
+            result_gauss += wg[j] * fsum;
+            result_kronrod += wgk[jtw] * fsum;
+            result_abs += wgk[jtw] * (std::fabs(fval1) + std::fabs(fval2));
+        }
+        for (size_t j = 0; j < 4; j++) {
+            const size_t jtwm1 = j * 2;
+            const double fval1 = fv1[jtwm1 * nvalues + k];
+            const double fval2 = fv2[jtwm1 * nvalues + k];
+            result_kronrod += wgk[jtwm1] * (fval1 + fval2);
+            result_abs += wgk[jtwm1] * (std::fabs(fval1) + std::fabs(fval2));
+        }
+
+        const double mean = result_kronrod * 0.5;
+        double result_asc = wgk[7] * std::fabs(fcenter[k] - mean);
+        for (size_t j = 0; j < 7; j++) {
+            result_asc += wgk[j] * (std::fabs(fv1[j * nvalues + k] - mean) +
+                                    std::fabs(fv2[j * nvalues + k] - mean));
+        }
+
+        const double err = (result_kronrod - result_gauss) * half_length;
+        result[k] = result_kronrod * half_length;
+        resabs[k] = result_abs * abs_half_length;
+        resasc[k] = result_asc * abs_half_length;
+        abserr[k] = rescale_error(err, resabs[k], resasc[k]);
+    }
+}
+
+//! The largest error of the integrands that have not converged yet, or of all
+//! integrands if they have, relative to their tolerance
+double VectorQag::relative_error(const double* error, size_t n, bool converged) const {
+    double largest = 0.;
+    for (size_t k = 0; k < n; k++) {
+        if (converged || errsum[k] > tolerance[k]) {
+            double relative = tolerance[k] > 0 ? error[k] / tolerance[k] : error[k];
+            if (relative > largest) {
+                largest = relative;
+            }
+        }
+    }
+    return largest;
+}
+
+void VectorQag::integrate(VectorFunction f, void* params, size_t n, double a, double b,
+                          double epsabs, double epsrel, double* result) {
+    alist[0] = a;
+    blist[0] = b;
+    qk15(f, params, n, a, b, &rlist[0], &elist[0]);
+
+    // Integrands for which the first estimate is good enough, or cannot be
+    // improved because of roundoff, are done; as in gsl_integration_qag
+    bool done = true;
+    for (size_t k = 0; k < n; k++) {
+        double result0 = rlist[k], abserr0 = elist[k];
+        area[k] = result0;
+        errsum[k] = abserr0;
+        tolerance[k] = std::max(epsabs, epsrel * std::fabs(result0));
+        roundoff_type1[k] = roundoff_type2[k] = 0;
+        double round_off = 50 * dbl_epsilon * resabs[k];
+        bool accepted = (abserr0 <= round_off && abserr0 > tolerance[k]) ||
+                        (abserr0 <= tolerance[k] && abserr0 != resasc[k]) || abserr0 == 0.0;
+        done = done && accepted;
+    }
+    if (done || limit == 1) {
+        for (size_t k = 0; k < n; k++) {
+            result[k] = rlist[k];
+        }
+        return;
+    }
+
+    size_t size = 1;    // number of subintervals
+    size_t imax = 0;    // the subinterval with the largest (relative) error
+    size_t iteration = 1;
+    bool error_type = false;
+    bool converged;
+    do {
+        double a1 = alist[imax];
+        double b1 = 0.5 * (alist[imax] + blist[imax]);
+        double a2 = b1;
+        double b2 = blist[imax];
+        double* r_i = &rlist[imax * nvalues];
+        double* e_i = &elist[imax * nvalues];
+
+        qk15(f, params, n, a1, b1, area1.data(), error1.data());
+        resasc1 = resasc;
+        qk15(f, params, n, a2, b2, area2.data(), error2.data());
+
+        converged = true;
+        for (size_t k = 0; k < n; k++) {
+            double area12 = area1[k] + area2[k];
+            double error12 = error1[k] + error2[k];
+
+            errsum[k] += (error12 - e_i[k]);
+            area[k] += area12 - r_i[k];
+
+            if (resasc1[k] != error1[k] && resasc[k] != error2[k]) {
+                double delta = r_i[k] - area12;
+                if (std::fabs(delta) <= 1.0e-5 * std::fabs(area12) && error12 >= 0.99 * e_i[k]) {
+                    roundoff_type1[k]++;
+                }
+                if (iteration >= 10 && error12 > e_i[k]) {
+                    roundoff_type2[k]++;
+                }
+            }
+
+            tolerance[k] = std::max(epsabs, epsrel * std::fabs(area[k]));
+            if (errsum[k] > tolerance[k]) {
+                converged = false;
+                if (roundoff_type1[k] >= 6 || roundoff_type2[k] >= 20) {
+                    error_type = true;
+                }
+            }
+        }
+        if (!converged && subinterval_too_small(a1, a2, b2)) {
+            error_type = true;
+        }
+
+        // The half with the largest error takes the place of the bisected
+        // subinterval, the other one is appended
+        size_t inew = size;
+        bool swap = relative_error(error2.data(), n, converged) >
+                    relative_error(error1.data(), n, converged);
+        alist[imax] = swap ? a2 : a1;
+        blist[imax] = swap ? b2 : b1;
+        alist[inew] = swap ? a1 : a2;
+        blist[inew] = swap ? b1 : b2;
+        for (size_t k = 0; k < n; k++) {
+            rlist[imax * nvalues + k] = swap ? area2[k] : area1[k];
+            elist[imax * nvalues + k] = swap ? error2[k] : error1[k];
+            rlist[inew * nvalues + k] = swap ? area1[k] : area2[k];
+            elist[inew * nvalues + k] = swap ? error1[k] : error2[k];
+        }
+        size++;
+
+        imax = 0;
+        double largest = relative_error(&elist[0], n, converged);
+        for (size_t i = 1; i < size; i++) {
+            double relative = relative_error(&elist[i * nvalues], n, converged);
+            if (relative > largest) {
+                largest = relative;
+                imax = i;
+            }
+        }
+        iteration++;
+    } while (iteration < limit && !error_type && !converged);
+
+    for (size_t k = 0; k < n; k++) {
+        result[k] = 0.;
+        for (size_t i = 0; i < size; i++) {
+            result[k] += rlist[i * nvalues + k];
+        }
+    }
+}
+
+}    // namespace kariba
@@ -11,7 +11,10 @@
 namespace kariba {
 
 //! Class constructor to initialize object
-Kappa::Kappa(size_t size) : Particles(size) {
+Kappa::Kappa(size_t size) : Particles(size) { reset(); }
+
+void Kappa::reset() {
+    Particles::reset();
 
     knorm = 1.;
 
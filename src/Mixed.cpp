@@ -3,8 +3,8 @@
 
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_math.h>
-#include <gsl/gsl_sf_bessel.h>
 
+#include "kariba/Bessel.hpp"
 #include "kariba/Mixed.hpp"
 #include "kariba/Particles.hpp"
 #include "kariba/constants.hpp"
@@ -12,7 +12,11 @@
 namespace kariba {
 
 //! Class constructors to initialize object
-Mixed::Mixed(size_t size) : Particles(size) {
+Mixed::Mixed(size_t size) : Particles(size) { reset(); }
+
+void Mixed::reset() {
+    Particles::reset();
+
     thnorm = 1.;
     plnorm = 1.;
 
@@ -207,7 +211,7 @@ double Mixed::K2(double x) {
     if (x < 0.1) {
         res = 2. / x / x;
     } else {
-        res = gsl_sf_bessel_Kn(2, x);
+        res = bessel_k2(x);
     }
 
     return res;
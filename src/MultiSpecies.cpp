@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <gsl/gsl_spline.h>
+
+#include "kariba/MultiSpecies.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+MultiSpecies::MultiSpecies(size_t size) : Particles(size) { reset(); }
+
+void MultiSpecies::reset() {
+    Particles::reset();
+
+    nspecies = 0;
+
+    mass_gr = constants::emgm;
+    mass_kev = constants::emgm * constants::gr_to_kev;
+}
+
+//! Set up the common grid, logarithmically spaced between gmin and gmax, and
+//! clear the summed densities
+void MultiSpecies::set_gamma(double gmin, double gmax) {
+    reset();
+
+    double ginc = (std::log10(gmax) - std::log10(gmin)) / static_cast<double>(gamma.size() - 1);
+    for (size_t i = 0; i < gamma.size(); i++) {
+        gamma[i] = std::pow(10., std::log10(gmin) + static_cast<double>(i) * ginc);
+    }
+    // Avoid round-off pushing the end points outside the range of the species
+    gamma[0] = gmin;
+    gamma[gamma.size() - 1] = gmax;
+
+    for (size_t i = 0; i < p.size(); i++) {
+        p[i] = std::sqrt(gamma[i] * gamma[i] - 1.) * mass_gr * constants::cee;
+    }
+}
+
+//! Interpolate the energy density of a single species onto the common grid and
+//! add it to the total. Species with a different particle mass are skipped,
+//! since they cannot share the Lorentz factor grid
+void MultiSpecies::add_species(const Particles& species) {
+    Span<const double> sp_gamma = species.get_gamma();
+    Span<const double> sp_gdens = species.get_gdens();
+    size_t size = sp_gamma.size();
+
+    if (species.get_mass() != mass_gr) {
+        std::cerr << "Species with a different particle mass can not be merged; skipping it\n";
+        return;
+    }
+
+    gsl_interp_accel* acc = gsl_interp_accel_alloc();
+    gsl_spline* spline = gsl_spline_alloc(gsl_interp_steffen, size);
+    gsl_spline_init(spline, sp_gamma.data(), sp_gdens.data(), size);
+
+    for (size_t i = 0; i < gamma.size(); i++) {
+        if (gamma[i] >= sp_gamma.front() && gamma[i] <= sp_gamma.back()) {
+            gdens[i] = gdens[i] + std::max(gsl_spline_eval(spline, gamma[i], acc), 0.);
+        }
+    }
+
+    gsl_spline_free(spline);
+    gsl_interp_accel_free(acc);
+
+    nspecies++;
+    initialize_pdens();
+    gdens_differentiate();
+}
+
+//! Merge a set of species onto a grid that covers all of them
+void MultiSpecies::merge(const std::vector<const Particles*>& species) {
+    double gmin = HUGE_VAL;
+    double gmax = 0.;
+
+    for (const Particles* sp : species) {
+        gmin = std::min(gmin, sp->get_gamma().front());
+        gmax = std::max(gmax, sp->get_gamma().back());
+    }
+
+    if (species.empty() || gmin >= gmax) {
+        std::cerr << "No species with a valid range of Lorentz factors to merge\n";
+        return;
+    }
+
+    set_gamma(gmin, gmax);
+    for (const Particles* sp : species) {
+        add_species(*sp);
+    }
+}
+
+}    // namespace kariba
@@ -1,12 +1,16 @@
+#include <algorithm>
 #include <array>
 #include <cmath>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <vector>
 
 #include <gsl/gsl_integration.h>
 
+#include "kariba/Diagnostics.hpp"
+#include "kariba/GammaRays.hpp"
+#include "kariba/Integration.hpp"
 #include "kariba/Neutrinos_pg.hpp"
+#include "kariba/Photomeson.hpp"
 #include "kariba/Radiation.hpp"
 #include "kariba/constants.hpp"
 
@@ -106,114 +110,268 @@ Neutrinos_pg::Neutrinos_pg(size_t size, double Emin, double Emax) : Radiation(si
     }
 }
 
+using HetaKernel = double (*)(double, void*);
+using PhiKernel = double (*)(double, double, double, double, double, double);
+static PhiKernel phi_kernel(Product product);
+
+//! Parameters of the integrand of eq. 70 from KA08 for several products at
+//! once; the proton and target photon densities are shared by all of them
+struct HetaVectorParams {
+    double eta;
+    double eta_zero;
+    double E;
+    double gp_min;
+    double gp_max;
+    gsl_spline* spline_Jp;
+    gsl_interp_accel* acc_Jp;
+    gsl_interp_accel* acc_ng;
+    gsl_spline* spline_ng;
+    double nu_min;
+    double nu_max;
+    std::vector<PhiKernel> Phi;    // per product: the spectrum, and its parameters at this η
+    std::vector<double> s;
+    std::vector<double> delta;
+    std::vector<double> Beta;
+};
+
+//! Same as Heta, for every product in the parameters
+static void Heta_vector(double x, double* f, void* pars) {
+    HetaVectorParams* params = static_cast<HetaVectorParams*>(pars);
+    double eta = params->eta;
+
+    double Ep = params->E / std::pow(10., x);
+    double fp = colliding_protons(params->spline_Jp, params->acc_Jp, params->gp_min,
+                                  params->gp_max, Ep);
+    double fph = photons_jet(eta, Ep, params->spline_ng, params->acc_ng, params->nu_min,
+                             params->nu_max);
+    double fpfph = fp * fph;
+    double xp = std::pow(10., x);
+    for (size_t k = 0; k < params->Phi.size(); k++) {
+        double Phi = params->Phi[k](eta, params->eta_zero, xp, params->s[k], params->delta[k],
+                                    params->Beta[k]);
+        f[k] = fpfph * Phi * std::log(10.) / Ep;
+    }
+}
+
 //************************************************************************************************************
-void Neutrinos_pg::set_neutrinos(double gp_min, double gp_max, gsl_interp_accel* acc_Jp,
+void Neutrinos_pg::set_neutrinos(double gp_min, double gp_max, gsl_interp_accel* /*acc_Jp*/,
                                  gsl_spline* spline_Jp, const std::vector<double>& en_perseg,
                                  const std::vector<double>& lum_perseg, size_t nphot,
                                  const std::string& outputConfiguration, const std::string& flavor,
                                  int infosw, std::string_view source) {
+    set_products(gp_min, gp_max, spline_Jp, en_perseg, lum_perseg, nphot, outputConfiguration,
+                 {flavor}, {this}, infosw, source);
+}
+
+void Neutrinos_pg::set_neutrinos(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                                 const PhotonField& field, const std::string& outputConfiguration,
+                                 const std::string& flavor, int infosw, std::string_view source) {
+    set_products(gp_min, gp_max, spline_Jp, field, outputConfiguration, {flavor}, {this}, infosw,
+                 source);
+}
+
+void Neutrinos_pg::set_products(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                                const std::vector<double>& en_perseg,
+                                const std::vector<double>& lum_perseg, size_t nphot,
+                                const std::string& outputConfiguration,
+                                const std::vector<std::string>& flavors,
+                                const std::vector<Neutrinos_pg*>& products, int infosw,
+                                std::string_view source) {
+    if (products.empty()) {
+        return;
+    }
+    PhotonField field(nphot);
+    field.set_field(en_perseg, lum_perseg, products[0]->r, products[0]->vol);
+    set_products(gp_min, gp_max, spline_Jp, field, outputConfiguration, flavors, products, infosw,
+                 source);
+}
+
+void Neutrinos_pg::set_products(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                                const PhotonField& field, const std::string& outputConfiguration,
+                                const std::vector<std::string>& flavors,
+                                const std::vector<Neutrinos_pg*>& products, int infosw,
+                                std::string_view source) {
+
+    const size_t nproducts = products.size();
+    if (nproducts == 0) {
+        return;
+    }
+    if (flavors.size() != nproducts) {
+        std::cerr << "Got " << flavors.size() << " flavors for " << nproducts << " products!"
+                  << std::endl;
+        exit(1);
+    }
+    const Neutrinos_pg& first = *products[0];
+    for (const Neutrinos_pg* product : products) {
+        if (product->en_phot != first.en_phot || product->r != first.r ||
+            product->vol != first.vol) {
+            std::cerr << "All products must have the same energy grid and geometry!" << std::endl;
+            exit(1);
+        }
+    }
 
-    std::ofstream PhotopionFile;    // for plotting
+    std::vector<Diagnostics::Table*> PhotopionTable(nproducts, nullptr);    // for plotting
     if (infosw >= 2) {
-        std::string filepath;
-        if (source.compare("JET") == 0) {
-            filepath = outputConfiguration + "/Output/Neutrinos/" + flavor + "_pg.dat";
-        } else {
+        if (source.compare("JET") != 0) {
             std::cerr << "Wrong source; cannot be " << source << " but rather JET!" << std::endl;
             exit(1);
         }
-        if (not(flavor.compare("electrons") == 0 || flavor.compare("positrons") == 0)) {
-            PhotopionFile.open(filepath, std::ios::app);
+        for (size_t k = 0; k < nproducts; k++) {
+            std::string filepath =
+                outputConfiguration + "/Output/Neutrinos/" + flavors[k] + "_pg.dat";
+            if (not(flavors[k].compare("electrons") == 0 ||
+                    flavors[k].compare("positrons") == 0)) {
+                PhotopionTable[k] = &diagnostics().table(filepath, {15, 25, 25});
+            }
         }
     }
     const size_t N = 10;
-    double Epion = 139.6e6 / constants::erg;    // rest mass of pion in erg
-    double eta, deta;                           // eta parameter: η = 4εE_p/(m_p^2*c^4) and its step
-    double eta_zero = 0.313;                    // eq 16 from Kelner & Aharonian 08
-    double Hfunction;                           // the quantity that we intergrate for every eta
-    double dNdEv;                               // spectrum of products in #/erg/cm3/sec
-    double eta_max = 99.99;                     // max η
-    double eta_min = 1.10;                      // min η
-    double nu_min = en_perseg[0] / constants::herg;            // the min freq of photon targets
-    double nu_max = en_perseg[nphot - 1] / constants::herg;    // the max freq of photon targets
-    std::vector<double> freq;     // frequency of photons per segment in Hz
-    std::vector<double> Uphot;    // diff energy density per segment in #/cm3/erg
-
-    if (flavor.compare("electrons") == 0 || flavor.compare("antielectron") == 0) {
-        eta_min = 3.001;
+    double eta_zero = 0.313;    // eq 16 from Kelner & Aharonian 08
+    double eta_max = 99.99;     // max η
+    double nu_min = field.get_numin();    // the min freq of photon targets
+    double nu_max = field.get_numax();    // the max freq of photon targets
+    gsl_spline* spline_ng = field.get_spline();
+
+    // The products are grouped by their η grid: the electrons and electron
+    // antineutrinos start at a higher η. All products in a group share the η
+    // nodes, and with them the proton and target photon densities in the
+    // integrand. The spectrum parameters at each node are the same for every
+    // product energy.
+    struct EtaGroup {
+        double eta_min;
+        double deta;    // step of η = 4εE_p/(m_p^2*c^4)
+        std::vector<size_t> members;
+        std::vector<double> Epion;    // rest mass of pion in erg, per member
+        std::vector<PhiKernel> Phi;
+        std::array<double, N> eta_nodes;
+        std::vector<std::array<double, N>> s_nodes, delta_nodes, Beta_nodes;
+    };
+    std::array<EtaGroup, 2> groups;
+    groups[0].eta_min = 1.10;
+    groups[1].eta_min = 3.001;
+    for (size_t k = 0; k < nproducts; k++) {
+        const Product product = product_from_string(flavors[k]);
+        EtaGroup& group =
+            (product == Product::electrons || product == Product::antielectron) ? groups[1]
+                                                                                 : groups[0];
+        group.members.push_back(k);
+        group.Epion.push_back((product == Product::gamma_rays ? 137.5e6 : 139.6e6) /
+                              constants::erg);
+        group.Phi.push_back(phi_kernel(product));
+        group.s_nodes.emplace_back();
+        group.delta_nodes.emplace_back();
+        group.Beta_nodes.emplace_back();
     }
-    if (flavor.compare("gamma_rays") == 0) {
-        Epion = 137.5e6 / constants::erg;
+    for (EtaGroup& group : groups) {
+        group.deta = std::log10(eta_max / group.eta_min) / (N - 1);
+        for (size_t j = 0; j < N; j++) {
+            group.eta_nodes[j] =
+                eta_zero *
+                (std::pow(10., std::log10(group.eta_min) + static_cast<double>(j) * group.deta));
+        }
+        for (size_t m = 0; m < group.members.size(); m++) {
+            const Product product = product_from_string(flavors[group.members[m]]);
+            for (size_t j = 0; j < N; j++) {
+                tables_photomeson(group.s_nodes[m][j], group.delta_nodes[m][j],
+                                  group.Beta_nodes[m][j], product,
+                                  group.eta_nodes[j] / eta_zero);
+            }
+        }
     }
 
-    for (size_t k = 0; k < nphot; k++) {
-        freq.push_back(en_perseg[k] / constants::herg);    // Hz from erg
-        Uphot.push_back(lum_perseg[k] *
-                        (r / constants::cee /
-                         (constants::herg * constants::herg * freq[k] * vol)));    // #/cm3/erg
-    }
+    // Every thread has its own interpolation accelerators and integration
+    // workspace; the splines are only read. Each energy bin is computed by a
+    // single thread, so the result does not depend on the number of threads.
+#pragma omp parallel
+    {
+        gsl_interp_accel* acc_Jp_thread = gsl_interp_accel_alloc();
+        gsl_interp_accel* acc_ng_thread = gsl_interp_accel_alloc();
+        VectorQag w1(nproducts, 100);
+        HetaVectorParams F1params{0.,        eta_zero, 0.,     gp_min,        gp_max,
+                                  spline_Jp, acc_Jp_thread, acc_ng_thread, spline_ng,
+                                  nu_min,    nu_max,   {},     {},            {},
+                                  {}};
+        std::vector<size_t> active;
+        std::vector<double> result1(nproducts), sum(nproducts);
+
+#pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < first.en_phot.size(); i++) {    // for every neutrino of energy
+            double Ev = first.en_phot[i];
+            F1params.E = Ev;
+            for (const EtaGroup& group : groups) {
+                // The products of this group above the pion threshold
+                active.clear();
+                F1params.Phi.clear();
+                for (size_t m = 0; m < group.members.size(); m++) {
+                    if (Ev > group.Epion[m] &&
+                        Ev <= gp_max * constants::pmgm * constants::cee * constants::cee) {
+                        active.push_back(m);
+                        F1params.Phi.push_back(group.Phi[m]);
+                    }
+                    products[group.members[m]]->num_phot[i] = 1.e-100;    // in #/erg/cm3/sec
+                }
+                if (active.empty()) {
+                    continue;
+                }
+                F1params.s.resize(active.size());
+                F1params.delta.resize(active.size());
+                F1params.Beta.resize(active.size());
+                std::fill(sum.begin(), sum.end(), 0.0);
+                for (size_t j = 0; j < N; j++) {    // eq 69 from KA08
+                    double eta = group.eta_nodes[j];
+                    F1params.eta = eta;
+                    for (size_t a = 0; a < active.size(); a++) {
+                        F1params.s[a] = group.s_nodes[active[a]][j];
+                        F1params.delta[a] = group.delta_nodes[active[a]][j];
+                        F1params.Beta[a] = group.Beta_nodes[active[a]][j];
+                    }
+                    double max = std::log10(
+                        Ev / (gp_min * constants::pmgm * constants::cee * constants::cee));
+                    double min = std::log10(
+                        Ev / (gp_max * constants::pmgm * constants::cee * constants::cee));
+                    w1.integrate(&Heta_vector, &F1params, active.size(), min, max, 1e0, 1e0,
+                                 result1.data());
+                    for (size_t a = 0; a < active.size(); a++) {
+                        double Hfunction =
+                            std::pow(constants::pmgm * constants::cee * constants::cee, 2) / 4. *
+                            result1[a];    // eq 70 from KA08
+                        sum[a] += Hfunction * group.deta * eta * std::log(10.);
+                    }
+                }
+                for (size_t a = 0; a < active.size(); a++) {
+                    products[group.members[active[a]]]->num_phot[i] =
+                        sum[a];    // in #/erg/cm3/sec
+                }
+            }
 
-    // Interpolation for jet photon distribution
-    gsl_interp_accel* acc_ng = gsl_interp_accel_alloc();
-    gsl_spline* spline_ng = gsl_spline_alloc(gsl_interp_steffen, nphot);
-    gsl_spline_init(spline_ng, freq.data(), Uphot.data(), nphot);
-
-    deta = std::log10(eta_max / eta_min) / (N - 1);
-#pragma omp parallel for private(eta, Hfunction,                                                   \
-                                     dNdEv)          // possibly lost: 9,424 bytes in 31 blocks
-    for (size_t i = 0; i < en_phot.size(); i++) {    // for every neutrino of energy en_phot[i](erg)
-        double sum;
-        double Ev = en_phot[i];
-        if (Ev > Epion &&
-            Ev <= gp_max * constants::pmgm * constants::cee * constants::cee) {    // in erg
-            sum = 0.0;
-            gsl_integration_workspace* w1 = gsl_integration_workspace_alloc(100);
-            double result1, error1;
-            gsl_function F1;
-            for (size_t j = 0; j < N; j++) {    // eq 69 from KA08
-                eta =
-                    eta_zero * (std::pow(10., std::log10(eta_min) + static_cast<double>(j) * deta));
-                auto F1params = HetaParams{eta,    eta_zero, Ev,     gp_min,    gp_max, spline_Jp,
-                                           acc_Jp, flavor,   acc_ng, spline_ng, nu_min, nu_max};
-                F1.function = &Heta;
-                F1.params = &F1params;
-                double max =
-                    std::log10(Ev / (gp_min * constants::pmgm * constants::cee * constants::cee));
-                double min =
-                    std::log10(Ev / (gp_max * constants::pmgm * constants::cee * constants::cee));
-                gsl_integration_qag(&F1, min, max, 1e0, 1e0, 100, 1, w1, &result1, &error1);
-                // Have to increase to 3 to get a good shape without arificial
-                // features
-                Hfunction = std::pow(constants::pmgm * constants::cee * constants::cee, 2) / 4. *
-                            result1;    // eq 70 from KA08
-                sum += Hfunction * deta * eta * std::log(10.);
+            for (Neutrinos_pg* product : products) {
+                double dNdEv = product->num_phot[i];    // in #/erg/cm3/sec
+                product->num_phot[i] = dNdEv * constants::herg * Ev * product->vol;    // erg/sec/Hz
+                product->en_phot_obs[i] = Ev * product->dopfac;                       //*dopfac;
+                // L'_v' -> L_v
+                product->num_phot_obs[i] =
+                    product->num_phot[i] * std::pow(product->dopfac, product->dopnum);
             }
-            dNdEv = sum;    // in #/erg/cm3/sec
-            gsl_integration_workspace_free(w1);
-        } else {
-            dNdEv = 1.e-100;    // in #/erg/cm3/sec
         }
-        num_phot[i] = dNdEv * constants::herg * en_phot[i] * vol;    // erg/sec/Hz
-        en_phot_obs[i] = en_phot[i] * dopfac;                        //*dopfac;
-        num_phot_obs[i] = num_phot[i] * std::pow(dopfac, dopnum);    //*dopfac*dopfac;
-                                                                     ////L'_v' -> L_v
-    }
 
-    if ((infosw >= 2) && !(flavor.compare("electrons") == 0 || flavor.compare("positrons") == 0)) {
-        for (size_t i = 0; i < en_phot.size(); i++) {
-            PhotopionFile << std::left << std::setw(15) << en_phot[i] << std::setw(25)
-                          << num_phot[i] / (constants::herg * en_phot[i] * vol) << std::setw(25)
-                          << num_phot[i] / (constants::herg * en_phot[i]) << std::endl;
-        }
+        gsl_interp_accel_free(acc_ng_thread);
+        gsl_interp_accel_free(acc_Jp_thread);
     }
 
-    if (infosw >= 2) {
-        PhotopionFile.close();
+    for (size_t k = 0; k < nproducts; k++) {
+        if (PhotopionTable[k] != nullptr) {
+            const Neutrinos_pg& product = *products[k];
+            for (size_t i = 0; i < product.en_phot.size(); i++) {
+                PhotopionTable[k]->add_row(
+                    {product.en_phot[i],
+                     product.num_phot[i] / (constants::herg * product.en_phot[i] * product.vol),
+                     product.num_phot[i] / (constants::herg * product.en_phot[i])});
+            }
+        }
     }
-    gsl_spline_free(spline_ng);
-    gsl_interp_accel_free(acc_ng);
 }
 
+template <Product P>
 double Heta(double x, void* pars) {
     // eq 70 from KA08 for pairs and writen as {0< x=Ee/Ep <1} Ee/Epmax <
     // x=Ee/Ep <Ee/Epmin
@@ -225,11 +383,13 @@ double Heta(double x, void* pars) {
     double gp_max = params->gp_max;
     gsl_spline* spline_Jp = params->spline_Jp;
     gsl_interp_accel* acc_Jp = params->acc_Jp;
-    std::string product = params->product;
     gsl_interp_accel* acc_ng = params->acc_ng;
     gsl_spline* spline_ng = params->spline_ng;
     double nu_min = params->nu_min;
     double nu_max = params->nu_max;
+    double s = params->s;
+    double delta = params->delta;
+    double Beta = params->Beta;
 
     double fp;         // number density of accelerated protons in #/cm3/erg
     double fph;        // number density of target photons in #/cm3/Hz
@@ -244,30 +404,55 @@ double Heta(double x, void* pars) {
                       // fph_jet function
     //	double Tstar = 2.7;
     //	fph = photon_field(eta,Ep,Tstar);
-    Phi = PhiFunc(eta, eta_zero, std::pow(10., x), product);
+    Phi = PhiFunc<P>(eta, eta_zero, std::pow(10., x), s, delta, Beta);
     return fp * fph * Phi * std::log(10.) / Ep;    // tod: replace std::log(10) with m_ln10
 }
 
+//! The integrand for a given product, to be selected once per spectrum rather
+//! than for every evaluation
+static HetaKernel heta_kernel(Product product) {
+    switch (product) {
+    case Product::gamma_rays:
+        return &Heta<Product::gamma_rays>;
+    case Product::electrons:
+        return &Heta<Product::electrons>;
+    case Product::positrons:
+        return &Heta<Product::positrons>;
+    case Product::muon:
+        return &Heta<Product::muon>;
+    case Product::antimuon:
+        return &Heta<Product::antimuon>;
+    case Product::electron:
+        return &Heta<Product::electron>;
+    case Product::antielectron:
+        return &Heta<Product::antielectron>;
+    default:
+        return &Heta<Product::unknown>;
+    }
+}
+
+double Heta(double x, void* pars) {
+    return heta_kernel(static_cast<HetaParams*>(pars)->product)(x, pars);
+}
+
 //************************************************************************************************************
-double PhiFunc(double eta, double eta0, double x, std::string_view product) {
+template <Product P>
+double PhiFunc(double eta, double eta0, double x, double s, double delta, double Beta) {
     // eqs 27,28,29 etc for gamma rays with interpolation in the tables given by
     // KA08 and eqs 31,32,33,34,35,36,37,38,39,40,41 and tables for leptons
 
     double Phi;                  // spectrum of products
     double xminus, xplus;        // eq. 19 from KA08 for min/max energy of pion
     double r = 0.146;            // mpion/mproton = 0.146 for above expressions
-    double s, delta, Beta;       // the parameters for spectrum
     double xeta = eta / eta0;    // x_eta to distinguish from x = Ep/Ei -- it's
                                  // ρ sometimes in KA08
 
-    tables_photomeson(s, delta, Beta, product, xeta);
-
     xplus = 1. / (2. + 2. * eta) *
             (eta + r * r + sqrt((eta - r * r - 2. * r) * (eta - r * r + 2. * r)));
     xminus = 1. / (2. + 2. * eta) *
              (eta + r * r - sqrt((eta - r * r - 2. * r) * (eta - r * r + 2. * r)));
 
-    if (product.compare("gamma_rays") == 0) {
+    if constexpr (P == Product::gamma_rays) {
         double y;
         y = (x - xminus) / (xplus - xminus);
         if (x > xminus && x < xplus) {
@@ -278,7 +463,7 @@ double PhiFunc(double eta, double eta0, double x, std::string_view product) {
         } else {
             Phi = 1.e-100;
         }
-    } else if (product.compare("electrons") == 0 || product.compare("antielectron") == 0) {
+    } else if constexpr (P == Product::electrons || P == Product::antielectron) {
         double yprime, xplusprime, xminusprime, psi;
         xplus = 1. / (2. + 2. * eta) *
                 (eta - 2. * r + sqrt(eta * (eta - 4. * r * (1. + r))));    // eq40 max
@@ -301,8 +486,8 @@ double PhiFunc(double eta, double eta0, double x, std::string_view product) {
         } else {
             Phi = 1.e-100;
         }
-    } else if (product.compare("positrons") == 0 || product.compare("antimuon") == 0 ||
-               product.compare("electron") == 0) {
+    } else if constexpr (P == Product::positrons || P == Product::antimuon ||
+                         P == Product::electron) {
         double yprime, xplusprime, xminusprime, psi;
         xplusprime = xplus;
         xminusprime = xminus / 4.;
@@ -318,7 +503,7 @@ double PhiFunc(double eta, double eta0, double x, std::string_view product) {
         } else {
             Phi = 1.e-200;
         }
-    } else if (product.compare("muon") == 0) {
+    } else if constexpr (P == Product::muon) {
         double yprime, xplusprime, xminusprime, psi;
         if (xeta < 2.14) {
             xplusprime = 0.427 * xplus;
@@ -347,77 +532,127 @@ double PhiFunc(double eta, double eta0, double x, std::string_view product) {
     return Phi;
 }
 
-// The tables from KA08 for photomeson that give s,δ and B
-void tables_photomeson(double& s, double& delta, double& Beta, std::string_view product,
-                       double xeta) {
-    // Gamma rays from neutral pion decay:
-    size_t sizeTable;
-    if (product.compare("electrons") == 0 || product.compare("antielectron") == 0) {
-        sizeTable = 10;
-    } else if (product.compare("positrons") == 0 || product.compare("muon") == 0 ||
-               product.compare("antimuon") == 0 || product.compare("electron") == 0) {
-        sizeTable = 20;
-    } else {
-        std::cout << "wrong population" << std::endl;
-        sizeTable = 2;
+template double PhiFunc<Product::gamma_rays>(double, double, double, double, double, double);
+template double PhiFunc<Product::electrons>(double, double, double, double, double, double);
+template double PhiFunc<Product::positrons>(double, double, double, double, double, double);
+template double PhiFunc<Product::muon>(double, double, double, double, double, double);
+template double PhiFunc<Product::antimuon>(double, double, double, double, double, double);
+template double PhiFunc<Product::electron>(double, double, double, double, double, double);
+template double PhiFunc<Product::antielectron>(double, double, double, double, double, double);
+template double PhiFunc<Product::unknown>(double, double, double, double, double, double);
+
+double PhiFunc(double eta, double eta0, double x, Product product, double s, double delta,
+               double Beta) {
+    switch (product) {
+    case Product::gamma_rays:
+        return PhiFunc<Product::gamma_rays>(eta, eta0, x, s, delta, Beta);
+    case Product::electrons:
+        return PhiFunc<Product::electrons>(eta, eta0, x, s, delta, Beta);
+    case Product::positrons:
+        return PhiFunc<Product::positrons>(eta, eta0, x, s, delta, Beta);
+    case Product::muon:
+        return PhiFunc<Product::muon>(eta, eta0, x, s, delta, Beta);
+    case Product::antimuon:
+        return PhiFunc<Product::antimuon>(eta, eta0, x, s, delta, Beta);
+    case Product::electron:
+        return PhiFunc<Product::electron>(eta, eta0, x, s, delta, Beta);
+    case Product::antielectron:
+        return PhiFunc<Product::antielectron>(eta, eta0, x, s, delta, Beta);
+    default:
+        return PhiFunc<Product::unknown>(eta, eta0, x, s, delta, Beta);
+    }
+}
+
+//! The spectrum for a given product, to be selected once per spectrum rather
+//! than for every evaluation
+static PhiKernel phi_kernel(Product product) {
+    switch (product) {
+    case Product::gamma_rays:
+        return &PhiFunc<Product::gamma_rays>;
+    case Product::electrons:
+        return &PhiFunc<Product::electrons>;
+    case Product::positrons:
+        return &PhiFunc<Product::positrons>;
+    case Product::muon:
+        return &PhiFunc<Product::muon>;
+    case Product::antimuon:
+        return &PhiFunc<Product::antimuon>;
+    case Product::electron:
+        return &PhiFunc<Product::electron>;
+    case Product::antielectron:
+        return &PhiFunc<Product::antielectron>;
+    default:
+        return &PhiFunc<Product::unknown>;
     }
-    gsl_interp_accel* acc_sigma = gsl_interp_accel_alloc();
-    gsl_spline* spline_sigma = gsl_spline_alloc(gsl_interp_cspline, sizeTable);
-    gsl_interp_accel* acc_delta = gsl_interp_accel_alloc();
-    gsl_spline* spline_delta = gsl_spline_alloc(gsl_interp_cspline, sizeTable);
-    gsl_interp_accel* acc_Beta = gsl_interp_accel_alloc();
-    gsl_spline* spline_Beta = gsl_spline_alloc(gsl_interp_cspline, sizeTable);
-
-    if (product.compare("electrons") == 0) {
-        gsl_spline_init(spline_sigma, etaeTable.data(), seTable.data(), etaeTable.size());
-        gsl_spline_init(spline_delta, etaeTable.data(), deltaeTable.data(), etaeTable.size());
-        gsl_spline_init(spline_Beta, etaeTable.data(), BetaeTable.data(), etaeTable.size());
+}
+
+double PhiFunc(double eta, double eta0, double x, std::string_view product) {
+    const Product prod = product_from_string(product);
+    double s, delta, Beta;    // the parameters for spectrum
+    tables_photomeson(s, delta, Beta, prod, eta / eta0);
+    return PhiFunc(eta, eta0, x, prod, s, delta, Beta);
+}
+
+//! The splines through the KA08 tables for every product, set up on first use
+//! and shared afterwards. Returns nullptr for an unknown product.
+static const PhotomesonTable* photomeson_table(Product product) {
+    if (product == Product::electrons) {
+        static const PhotomesonTable table(etaeTable.data(), seTable.data(), deltaeTable.data(),
+                                           BetaeTable.data(), etaeTable.size());
+        return &table;
     }    // positrons from charged pion decay:
-    else if (product.compare("positrons") == 0) {
-        gsl_spline_init(spline_sigma, etaposTable.data(), sposTable.data(), etaposTable.size());
-        gsl_spline_init(spline_delta, etaposTable.data(), deltaposTable.data(), etaposTable.size());
-        gsl_spline_init(spline_Beta, etaposTable.data(), BetaposTable.data(), etaposTable.size());
+    else if (product == Product::positrons) {
+        static const PhotomesonTable table(etaposTable.data(), sposTable.data(),
+                                           deltaposTable.data(), BetaposTable.data(),
+                                           etaposTable.size());
+        return &table;
     }    // muon neutrinos
-    else if (product.compare("muon") == 0) {
-        gsl_spline_init(spline_sigma, eta_muonTable.data(), s_muonTable.data(),
-                        eta_muonTable.size());
-        gsl_spline_init(spline_delta, eta_muonTable.data(), delta_muonTable.data(),
-                        eta_muonTable.size());
-        gsl_spline_init(spline_Beta, eta_muonTable.data(), Beta_muonTable.data(),
-                        eta_muonTable.size());
+    else if (product == Product::muon) {
+        static const PhotomesonTable table(eta_muonTable.data(), s_muonTable.data(),
+                                           delta_muonTable.data(), Beta_muonTable.data(),
+                                           eta_muonTable.size());
+        return &table;
     }    // muon antineutrinos
-    else if (product.compare("antimuon") == 0) {
-        gsl_spline_init(spline_sigma, eta_antimuonTable.data(), s_antimuonTable.data(),
-                        eta_antimuonTable.size());
-        gsl_spline_init(spline_delta, eta_antimuonTable.data(), delta_antimuonTable.data(),
-                        eta_antimuonTable.size());
-        gsl_spline_init(spline_Beta, eta_antimuonTable.data(), Beta_atnimuonTable.data(),
-                        eta_antimuonTable.size());
+    else if (product == Product::antimuon) {
+        static const PhotomesonTable table(eta_antimuonTable.data(), s_antimuonTable.data(),
+                                           delta_antimuonTable.data(), Beta_atnimuonTable.data(),
+                                           eta_antimuonTable.size());
+        return &table;
     }    // electron neutrinos
-    else if (product.compare("electron") == 0) {
-        gsl_spline_init(spline_sigma, eta_electronTable.data(), s_electronTable.data(),
-                        eta_electronTable.size());
-        gsl_spline_init(spline_delta, eta_electronTable.data(), delta_electronTable.data(),
-                        eta_electronTable.size());
-        gsl_spline_init(spline_Beta, eta_electronTable.data(), Beta_electronTable.data(),
-                        eta_electronTable.size());
+    else if (product == Product::electron) {
+        static const PhotomesonTable table(eta_electronTable.data(), s_electronTable.data(),
+                                           delta_electronTable.data(), Beta_electronTable.data(),
+                                           eta_electronTable.size());
+        return &table;
     }    // electron antineutrinos
-    else if (product.compare("antielectron") == 0) {
-        gsl_spline_init(spline_sigma, eta_antielectronTable.data(), s_antielectronTable.data(),
-                        eta_antielectronTable.size());
-        gsl_spline_init(spline_delta, eta_antielectronTable.data(), delta_antielectronTable.data(),
-                        eta_antielectronTable.size());
-        gsl_spline_init(spline_Beta, eta_antielectronTable.data(), Beta_antielectronTable.data(),
-                        eta_antielectronTable.size());
+    else if (product == Product::antielectron) {
+        static const PhotomesonTable table(
+            eta_antielectronTable.data(), s_antielectronTable.data(),
+            delta_antielectronTable.data(), Beta_antielectronTable.data(),
+            eta_antielectronTable.size());
+        return &table;
     }
+    return nullptr;
+}
 
-    s = gsl_spline_eval(spline_sigma, xeta, acc_sigma);
-    delta = gsl_spline_eval(spline_delta, xeta, acc_delta);
-    Beta = gsl_spline_eval(spline_Beta, xeta, acc_Beta);
+// The tables from KA08 for photomeson that give s,δ and B
+void tables_photomeson(double& s, double& delta, double& Beta, Product product, double xeta) {
+    if (product == Product::gamma_rays) {
+        tables_photomeson_gamma(s, delta, Beta, xeta);
+        return;
+    }
+    const PhotomesonTable* table = photomeson_table(product);
+    if (table == nullptr) {
+        std::cout << "wrong population" << std::endl;
+        s = delta = Beta = 0.;
+        return;
+    }
+    table->eval(xeta, s, delta, Beta);
+}
 
-    gsl_spline_free(spline_sigma), gsl_interp_accel_free(acc_sigma);
-    gsl_spline_free(spline_delta), gsl_interp_accel_free(acc_delta);
-    gsl_spline_free(spline_Beta), gsl_interp_accel_free(acc_Beta);
+void tables_photomeson(double& s, double& delta, double& Beta, std::string_view product,
+                       double xeta) {
+    tables_photomeson(s, delta, Beta, product_from_string(product), xeta);
 }
 
 }    // namespace kariba
@@ -1,14 +1,19 @@
 #include <cmath>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <vector>
 
+#include "kariba/Diagnostics.hpp"
 #include "kariba/Neutrinos_pp.hpp"
 #include "kariba/Radiation.hpp"
 #include "kariba/constants.hpp"
 
 namespace kariba {
 
+template <Product P>
+static double distr_pp(double lEv, double lEpi);
+template <Product P>
+static double secondary_spectrum(double Ep, double y);
+
 Neutrinos_pp::Neutrinos_pp(size_t size, double Emin, double Emax) : Radiation(size) {
 
     en_phot_obs.resize(2 * en_phot_obs.size(), 0.0);
@@ -24,12 +29,24 @@ Neutrinos_pp::Neutrinos_pp(size_t size, double Emin, double Emax) : Radiation(si
 
 void Neutrinos_pp::set_neutrinos_pp(double pspec, double gammap_min, double gammap_max,
                                     double ntot_prot, double nwind, double plfrac,
-                                    gsl_interp_accel* acc_Jp, gsl_spline* spline_Jp,
+                                    gsl_interp_accel* /*acc_Jp*/, gsl_spline* spline_Jp,
                                     const std::string& outputConfiguration,
                                     const std::string& flavor, int infosw,
                                     std::string_view source) {
+    double Epcode_max = gammap_max * constants::pmgm * constants::cee * constants::cee *
+                        constants::erg * 1.e-12;    // The proton energy in TeV
+    set_neutrinos_pp(pspec, ntot_prot, nwind, plfrac,
+                     PPCollisionRate(gammap_min, Epcode_max, spline_Jp), outputConfiguration,
+                     flavor, infosw, source);
+}
 
-    std::ofstream NeutrinosppFile;    // for plotting
+void Neutrinos_pp::set_neutrinos_pp(double pspec, double ntot_prot, double nwind, double plfrac,
+                                    const PPCollisionRate& rate,
+                                    const std::string& outputConfiguration,
+                                    const std::string& flavor, int infosw,
+                                    std::string_view source, const HadronicConstants& hadronic) {
+
+    Diagnostics::Table* NeutrinosppTable = nullptr;    // for plotting
     if (infosw >= 2) {
         std::string filepath;
         if (source.compare("JET") == 0) {
@@ -38,99 +55,95 @@ void Neutrinos_pp::set_neutrinos_pp(double pspec, double gammap_min, double gamm
             std::cerr << "Wrong source; cannot be " << source << " but rather JET!" << std::endl;
             exit(1);
         }
-        NeutrinosppFile.open(filepath, std::ios::app);
+        NeutrinosppTable = &diagnostics().table(filepath, {15, 25, 25});
     }
 
-    double ntilde = multiplicity(pspec);    // The number of produced pions for
-                                            // a given proton distribution
+    double ntilde = hadronic.ntilde_leptons(pspec);    // The number of produced pions for
+                                                       // a given proton distribution
     double pp_targets = target_protons(ntot_prot, nwind, plfrac);
-    double Epcode_max = gammap_max * constants::pmgm * constants::cee * constants::cee *
-                        constants::erg * 1.e-12;    // The proton energy in TeV
+    double Epcode_max = rate.get_Epcode_max();    // The proton energy in TeV
 
-    int N = 60;    // Steps of the secondary particle (e.g., pion) energy
+    const int N = 60;    // Steps of the secondary particle (e.g., pion) energy
     double xmin = 1.e-3,
            xmax = 1.;                // min/max energy of decaying particle in Ep
-    double dy, y;                    // std::log of above
+    double dy;                       // std::log of above
     double Bprob = 0.;               // The probapility of production for pions
-    double Ev;                       // The energy of the neutrino in TeV
-    double Epimin, Epimax = 1.e6;    // The min/max energy of the pions and the
-                                     // respective exponents
-    double lEpi;                     // std::log10 of pion energy in TeV
-    double dw;                       // The logarithmic step with which the pion energy increases
-    double Ep;                       // The energy of the proton	in TeV
-    double sum;                      // for the integrals
-    double sinel;                    // The inelastic cross-section of pp collisions
-    double Jp;                       // The number density of protons from interpolation
-    double qpi;                      // The production rate of pions
-    double fv;                       // for the neutrino production (eq. 36 from Kelner+2006)
-    double Fv;                       // for the neutrino production (eq. 66 from Kelner+2006)
-    double Phiv;                     // The neutrino rate in #/TeV/cm3/sec
-    double Fnuspec;                  // Spectrum of muon neutrinos eq66 from Kelner+2006
+    double Epimax = 1.e6;            // The max energy of the pions
     double transition = 0.0;         // the transition from delta fuctions to distribution in TeV
     int i_init = 0;                  // the first nerutrino energy
+    std::vector<double> Phiv(en_phot.size());    // The neutrino rate in #/TeV/cm3/sec
 
-    if (flavor.compare("muon") == 0) {
+    const Product product = product_from_string(flavor);
+    if (product == Product::muon) {
         transition = 0.01;
         i_init = 3;    // from 3 otherwise I get to <Ep=1GeV
-        Bprob = prob();
-    } else if (flavor.compare("electron") == 0) {
+        Bprob = hadronic.prob;
+    } else if (product == Product::electron) {
         transition = 0.05;
-        Bprob = prob_fve();
+        Bprob = hadronic.prob_fve;
     }
+    // The tabulated kernels for the given flavour, selected once for all
+    // energies; other flavours give no neutrinos
+    const PPDistributionTable* distr = distr_pp_table(product);
+    const PPKernelTable* spectrum = secondary_spectrum_table(product);
     dy = std::log10(xmax / xmin) / (N - 1);
 
-    for (size_t j = 0; j < en_phot.size(); j++) {     // for every single Ev
-        Ev = en_phot[j] * constants::erg * 1.e-12;    // in TeV
+    // Every neutrino energy is independent, and σ_pp Jp is a shared table
+#pragma omp parallel for schedule(dynamic)
+    for (size_t j = 0; j < en_phot.size(); j++) {            // for every single Ev
+        double Ev = en_phot[j] * constants::erg * 1.e-12;    // in TeV
+        double lEv = std::log10(Ev);
+        double sum = 1.e-100;    // for the integrals
         if (Ev <= transition) {
-            Epimin = Ev + constants::mpionTeV * constants::mpionTeV / (4. * Ev);
-            dw = (std::log10(Epimax / Epimin)) / (N - 1);
-            sum = 1.e-100;
+            double Epimin = Ev + constants::mpionTeV * constants::mpionTeV / (4. * Ev);
+            // The logarithmic step with which the pion energy increases
+            double dw = (std::log10(Epimax / Epimin)) / (N - 1);
+            double lEpimin = std::log10(Epimin);
             for (int i = i_init; i < N; i++) {
-                lEpi = std::log10(Epimin) + i * dw;
-                Ep = constants::mprotTeV + std::pow(10., lEpi) / constants::Kpi;
-                sinel = sigma_pp(Ep);
-                Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                qpi = 2. * ntilde / constants::Kpi * sinel *
-                      Jp;    // The production rate of neutral pions
-                fv = distr_pp(std::log10(Ev), lEpi, flavor);
+                double lEpi = lEpimin + i * dw;    // std::log10 of pion energy in TeV
+                double Ep = constants::mprotTeV + std::pow(10., lEpi) / constants::Kpi;
+                // The production rate of neutral pions
+                double qpi = 2. * ntilde / constants::Kpi * rate.eval(Ep, std::log10(Ep));
+                // for the neutrino production (eq. 36 from Kelner+2006)
+                double fv = distr ? distr->eval(lEv, lEpi) : 0.;
                 // Fv =
                 // qpi*std::pow(10.,lEpi)/sqrt(std::pow(10.,(2.*lEpi))-mpionTeV*mpionTeV)*fv*Bprob;
-                Fv = qpi * std::pow(10., lEpi) / sqrt(std::pow(10., (2. * lEpi))) * fv * Bprob;
+                double Fv =
+                    qpi * std::pow(10., lEpi) / sqrt(std::pow(10., (2. * lEpi))) * fv * Bprob;
                 sum += dw * Fv;
             }    // end of if statement for energies greater than Ep_min
-            Phiv = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
+            Phiv[j] = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
         }    // end of for loop for all the pions
         else if ((Ev > transition) && (Ev <= Epcode_max)) {
-            sum = 1.e-100;
             for (int i = 0; i < N; i++) {
-                y = std::log10(xmin) + i * dy;
-                Ep = std::pow(10., (std::log10(Ev) - y));
+                double y = std::log10(xmin) + i * dy;
+                double lEp = lEv - y;
+                double Ep = std::pow(10., lEp);    // The energy of the proton in TeV
                 if (Ep >= .1 && Ep <= Epcode_max) {
-                    sinel = sigma_pp(Ep);
-                    Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                    Fnuspec = secondary_spectrum(Ep, y, flavor);
-                    sum += dy * (sinel * Jp * Fnuspec);
+                    // Spectrum of muon neutrinos eq66 from Kelner+2006
+                    double Fnuspec = spectrum ? spectrum->eval(lEp, y) : 0.;
+                    sum += dy * (rate.eval(Ep, lEp) * Fnuspec);
                 }
             }    // end of for loop for all the pions
-            Phiv = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
+            Phiv[j] = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
         } else {
-            Phiv = 1.e-100;
+            Phiv[j] = 1.e-100;
         }
-        num_phot[j] = Phiv * constants::herg * vol * Ev;    // erg/s/Hz per segment
-        en_phot_obs[j] = en_phot[j] * dopfac;               // *dopfac;
+        num_phot[j] = Phiv[j] * constants::herg * vol * Ev;    // erg/s/Hz per segment
+        en_phot_obs[j] = en_phot[j] * dopfac;                  // *dopfac;
         num_phot_obs[j] =
             num_phot[j] *
             std::pow(dopfac,
                      dopnum);    // dopfac*dopfac;			//L'_v' -> L_v
-
-        if (infosw >= 2) {
-            NeutrinosppFile << std::left << std::setw(15) << Ev * 1.e12 / constants::erg
-                            << std::setw(25) << Phiv / (1.e12 / constants::erg) << std::setw(25)
-                            << num_phot[j] / (constants::herg * en_phot[j]) << std::endl;
-        }
     }    // End of for loop for all the neutrino energies.
+
     if (infosw >= 2) {
-        NeutrinosppFile.close();
+        for (size_t j = 0; j < en_phot.size(); j++) {
+            double Ev = en_phot[j] * constants::erg * 1.e-12;    // in TeV
+            NeutrinosppTable->add_row({Ev * 1.e12 / constants::erg,
+                                       Phiv[j] / (1.e12 / constants::erg),
+                                       num_phot[j] / (constants::herg * en_phot[j])});
+        }
     }
 }    // End of function that produces the neutrinos from pp
 
@@ -169,13 +182,14 @@ double prob_fve() {    // it is the same as of electrons
     return Bprob;
 }
 
-double distr_pp(double lEv, double lEpi, std::string_view flavor) {
+template <Product P>
+static double distr_pp(double lEv, double lEpi) {
     double rmasses = .573;                     // r = 1-λ = m_μ^2/m_p^2 = 0.573.The ratio of muon
                                                // and proton energies
     double k = std::pow(10., (lEv - lEpi));    // x=Ev/Epion
     double Fvespec = 0.;                       // The spectrum of secondary electrons from pion
                                                // decay. Eq 62 from Kelner+06
-    if (flavor.compare("muon") == 0) {
+    if constexpr (P == Product::muon) {
         double lamda = 1. - rmasses;    // 1-rmasses
         double g0, gn, hn1, h0, hn2;    // for the neutrino production (eq.
                                         // 37-39 from Kelner et al. 2006)
@@ -200,7 +214,7 @@ double distr_pp(double lEv, double lEpi, std::string_view flavor) {
             fn = fn2;
         }
         Fvespec = fn;
-    } else if (flavor.compare("electron") == 0) {
+    } else if constexpr (P == Product::electron) {
         double gn, hn1, hn2, fve;    //(eqs. 40-43 from  Kelner et al. 2006)
 
         gn = 2. / (3. * (1. - rmasses) * (1. - rmasses)) *
@@ -227,12 +241,13 @@ double distr_pp(double lEv, double lEpi, std::string_view flavor) {
     return Fvespec;
 }
 
-double secondary_spectrum(double Ep, double y, std::string_view flavor) {
+template <Product P>
+static double secondary_spectrum(double Ep, double y) {
     double L = std::log(Ep);    // L = ln(Ep/1TeV) as definied in Kelner et al. 2006
                                 // for the cross section
     double Fvespec = 0.;        // The spectrum of secondary electrons from pion
                                 // decay. Eq 62 from Kelner+06
-    if (flavor.compare("muon") == 0) {
+    if constexpr (P == Product::muon) {
         double Betav2, bv2, kv2;      // for the neutrino production (eq. 63-69
                                       // from Kelner et al. 2006)
         double Fi1, Fi2, Fi3, Fv2;    // for the neutrino production (eq. 62
@@ -272,7 +287,7 @@ double secondary_spectrum(double Ep, double y, std::string_view flavor) {
             Fv1 = 0.;
         }
         Fvespec = Fv1 + Fv2;
-    } else if (flavor.compare("electron") == 0) {
+    } else if constexpr (P == Product::electron) {
         double Betae, be, yke;    // The sub-functions that describe the function F_ve(x,E_p)
                                   // that implies the number of elec neutrinos in the interval
                                   // (x,x+dx) per collision. In particular, eqs. 63-65 from
@@ -298,4 +313,63 @@ double secondary_spectrum(double Ep, double y, std::string_view flavor) {
     return Fvespec;
 }
 
+double distr_pp(double lEv, double lEpi, Product flavor) {
+    if (flavor == Product::muon) {
+        return distr_pp<Product::muon>(lEv, lEpi);
+    } else if (flavor == Product::electron) {
+        return distr_pp<Product::electron>(lEv, lEpi);
+    }
+    return 0.;
+}
+
+double distr_pp(double lEv, double lEpi, std::string_view flavor) {
+    return distr_pp(lEv, lEpi, product_from_string(flavor));
+}
+
+double secondary_spectrum(double Ep, double y, Product flavor) {
+    if (flavor == Product::muon) {
+        return secondary_spectrum<Product::muon>(Ep, y);
+    } else if (flavor == Product::electron) {
+        return secondary_spectrum<Product::electron>(Ep, y);
+    }
+    return 0.;
+}
+
+double secondary_spectrum(double Ep, double y, std::string_view flavor) {
+    return secondary_spectrum(Ep, y, product_from_string(flavor));
+}
+
+const PPDistributionTable* distr_pp_table(Product flavor) {
+    if (flavor == Product::muon) {
+        // f_ν1 (eq. 37 from Kelner et al. 2006) jumps by 1/λ at x = λ
+        const double lamda = 1. - .573;
+        static const PPDistributionTable table(&distr_pp<Product::muon>, pp_tables::lx_min,
+                                               pp_tables::lx_max, pp_tables::nx, lamda,
+                                               1. / lamda);
+        return &table;
+    } else if (flavor == Product::electron) {
+        static const PPDistributionTable table(&distr_pp<Product::electron>, pp_tables::lx_min,
+                                               pp_tables::lx_max, pp_tables::nx);
+        return &table;
+    }
+    return nullptr;
+}
+
+const PPKernelTable* secondary_spectrum_table(Product flavor) {
+    const int N = 60;
+    const double xmin = 1.e-3, xmax = 1.;
+    const double ymin = std::log10(xmin), dy = std::log10(xmax / xmin) / (N - 1);
+    if (flavor == Product::muon) {
+        static const PPKernelTable table(&secondary_spectrum<Product::muon>, pp_tables::lEp_min,
+                                         pp_tables::lEp_max, pp_tables::nEp, ymin, dy, N);
+        return &table;
+    } else if (flavor == Product::electron) {
+        static const PPKernelTable table(&secondary_spectrum<Product::electron>,
+                                         pp_tables::lEp_min, pp_tables::lEp_max, pp_tables::nEp,
+                                         ymin, dy, N);
+        return &table;
+    }
+    return nullptr;
+}
+
 }    // namespace kariba
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "kariba/Electrons.hpp"
+#include "kariba/GammaRays.hpp"
+#include "kariba/Neutrinos_pp.hpp"
+#include "kariba/PPTables.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+PPKernelTable::PPKernelTable(double (*kernel)(double Ep, double y), double lEp_min,
+                             double lEp_max, size_t nEp, double y_min, double dy, size_t ny)
+    : kernel(kernel), lEp_min(lEp_min), dlEp((lEp_max - lEp_min) / static_cast<double>(nEp - 1)),
+      nEp(nEp), y_min(y_min), dy(dy), ny(ny), values(nEp * ny) {
+    for (size_t i = 0; i < nEp; i++) {
+        double Ep = std::pow(10., lEp_min + static_cast<double>(i) * dlEp);
+        for (size_t j = 0; j < ny; j++) {
+            values[i * ny + j] = kernel(Ep, y_min + static_cast<double>(j) * dy);
+        }
+    }
+}
+
+double PPKernelTable::eval(double lEp, double y) const {
+    double u = (lEp - lEp_min) / dlEp;
+    double v = (y - y_min) / dy;
+    // allow for roundoff at the last nodes
+    if (u < 0. || u > static_cast<double>(nEp - 1) + 1e-9 || v < -1e-9 ||
+        v > static_cast<double>(ny - 1) + 1e-9) {
+        return kernel(std::pow(10., lEp), y);
+    }
+    size_t i = std::min(static_cast<size_t>(u), nEp - 2);
+    size_t j = std::min(static_cast<size_t>(std::max(v, 0.)), ny - 2);
+    double wu = u - static_cast<double>(i);
+    double wv = v - static_cast<double>(j);
+    const double* f0 = &values[i * ny + j];
+    const double* f1 = f0 + ny;
+    return (1. - wu) * ((1. - wv) * f0[0] + wv * f0[1]) + wu * ((1. - wv) * f1[0] + wv * f1[1]);
+}
+
+PPDistributionTable::PPDistributionTable(double (*distribution)(double lE, double lEpi),
+                                         double lx_min, double lx_max, size_t nx, double step_x,
+                                         double step_height)
+    : distribution(distribution), lx_min(lx_min),
+      dlx((lx_max - lx_min) / static_cast<double>(nx - 1)), nx(nx),
+      lstep_x(step_x > 0. ? std::log10(step_x) : -std::numeric_limits<double>::infinity()),
+      step_height(step_height), values(nx) {
+    for (size_t i = 0; i < nx; i++) {
+        double lx = lx_min + static_cast<double>(i) * dlx;
+        values[i] = distribution(lx, 0.);
+        if (std::pow(10., lx) <= step_x) {
+            values[i] -= step_height;
+        }
+    }
+}
+
+double PPDistributionTable::eval(double lE, double lEpi) const {
+    double lx = lE - lEpi;
+    double u = (lx - lx_min) / dlx;
+    if (u < 0. || u > static_cast<double>(nx - 1)) {
+        return distribution(lE, lEpi);
+    }
+    size_t i = std::min(static_cast<size_t>(u), nx - 2);
+    double w = u - static_cast<double>(i);
+    double f = (1. - w) * values[i] + w * values[i + 1];
+    if (lx <= lstep_x) {
+        f += step_height;
+    }
+    return f;
+}
+
+PPCollisionRate::PPCollisionRate(double gammap_min, double Epcode_max, gsl_spline* spline_Jp)
+    : gammap_min(gammap_min), Epcode_max(Epcode_max), spline_Jp(spline_Jp) {
+    const double Ethres = 1.22e-3;    // threshold energy (in TeV) for pp interactions
+    const double nodes_per_decade = 200.;
+    lEp_min = std::log10(std::max(gammap_min * constants::mprotTeV, Ethres));
+    double lEp_max = std::log10(Epcode_max);
+    if (!(lEp_max > lEp_min)) {    // no protons above the threshold
+        nEp = 0;
+        dlEp = 1.;
+        return;
+    }
+    nEp = static_cast<size_t>(std::ceil((lEp_max - lEp_min) * nodes_per_decade)) + 1;
+    dlEp = (lEp_max - lEp_min) / static_cast<double>(nEp - 1);
+    values.resize(nEp);
+    for (size_t i = 0; i < nEp; i++) {
+        double Ep = std::pow(10., lEp_min + static_cast<double>(i) * dlEp);
+        // as in proton_dist, but without the range check, which the end
+        // points may fail by roundoff
+        double gp = std::min(std::max(Ep / constants::mprotTeV, spline_Jp->x[0]),
+                             spline_Jp->x[spline_Jp->size - 1]);
+        values[i] = sigma_pp(Ep) * gsl_spline_eval(spline_Jp, gp, nullptr) / constants::mprotTeV;
+    }
+}
+
+double PPCollisionRate::eval(double Ep, double lEp) const {
+    double u = (lEp - lEp_min) / dlEp;
+    if (nEp < 2 || u < 0. || Ep > Epcode_max) {
+        return sigma_pp(Ep) * proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, nullptr);
+    }
+    size_t i = std::min(static_cast<size_t>(u), nEp - 2);
+    double w = u - static_cast<double>(i);
+    return (1. - w) * values[i] + w * values[i + 1];
+}
+
+const HadronicConstants& hadronic_constants() {
+    static const HadronicConstants hadronic{prob(), prob_fve()};
+    return hadronic;
+}
+
+}    // namespace kariba
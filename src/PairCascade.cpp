@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+
+#include "kariba/PairCascade.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+//! The grid of photon energies from numin to numax (in Hz) as set by
+//! Cyclosyn::set_frequency
+static std::vector<double> photon_grid(size_t size, double numin, double numax) {
+    std::vector<double> en(size);
+    double nuinc = (std::log10(numax) - std::log10(numin)) / static_cast<double>(size - 1);
+    for (size_t i = 0; i < size; i++) {
+        en[i] = std::pow(10., std::log10(numin) + static_cast<double>(i) * nuinc) * constants::herg;
+    }
+    return en;
+}
+
+PairCascade::~PairCascade() {
+    gsl_spline_free(spline_gdens), gsl_interp_accel_free(acc_gdens);
+    gsl_spline_free(spline_diff), gsl_interp_accel_free(acc_diff);
+}
+
+PairCascade::PairCascade(size_t size, double numin, double numax, size_t ngamma, double gmax)
+    : energy(photon_grid(size, numin, numax)), primary(size, 0.), nphot(size, 0.),
+      tau(size, 0.), field(size), gg(1.002, gmax, ngamma, energy), pairs(ngamma), syn(size),
+      ic(size, size) {
+    syn.set_frequency(numin, numax);
+    ic.set_frequency(numin, numax);
+    // multiple scatterings are followed by the generations
+    ic.set_niter(static_cast<size_t>(1));
+    set_beaming(90., 0., 1.);
+
+    spline_gdens = gsl_spline_alloc(gsl_interp_steffen, ngamma);
+    acc_gdens = gsl_interp_accel_alloc();
+    spline_diff = gsl_spline_alloc(gsl_interp_steffen, ngamma);
+    acc_diff = gsl_interp_accel_alloc();
+
+    r = 1.;
+    bfield = 0.;
+    max_generations = 20;
+    tolerance = 1e-3;
+    generations = 0;
+    converged = false;
+}
+
+void PairCascade::set_geometry(const std::string& geom, double l1, double l2) {
+    syn.set_geometry(geom, l1, l2);
+    ic.set_geometry(geom, l1, l2);
+    r = l1;
+}
+
+void PairCascade::set_beaming(double theta, double speed, double doppler) {
+    syn.set_beaming(theta, speed, doppler);
+    ic.set_beaming(theta, speed, doppler);
+}
+
+void PairCascade::set_bfield(double b) {
+    bfield = b;
+    syn.set_bfield(b);
+}
+
+void PairCascade::set_generations(size_t n, double tol) {
+    max_generations = n;
+    tolerance = tol;
+}
+
+void PairCascade::add_primary(const std::vector<double>& en, const std::vector<double>& lum) {
+    size_t n = en.size();
+    for (size_t i = 0; i < energy.size(); i++) {
+        if (energy[i] < en[0] || energy[i] > en[n - 1]) {
+            continue;
+        }
+        size_t k = static_cast<size_t>(std::upper_bound(en.begin(), en.end(), energy[i]) -
+                                       en.begin());
+        k = std::min(k == 0 ? 0 : k - 1, n - 2);
+        double w = std::log(energy[i] / en[k]) / std::log(en[k + 1] / en[k]);
+        if (lum[k] > 0. && lum[k + 1] > 0.) {
+            primary[i] += std::exp((1. - w) * std::log(lum[k]) + w * std::log(lum[k + 1]));
+        } else {
+            primary[i] += std::max((1. - w) * lum[k] + w * lum[k + 1], 0.);
+        }
+    }
+}
+
+void PairCascade::clear_primary() { std::fill(primary.begin(), primary.end(), 0.); }
+
+//! The photon density in the region, and so the escaping photons, are those
+//! produced reduced by 1/(1 + τγγ), as γγ absorption adds to the escape rate
+//! c/r a rate τγγ c/r
+void PairCascade::run() {
+    size_t size = energy.size();
+    size_t ngamma = gg.get_gamma().size();
+    double gmin = gg.get_gamma().front(), gmax = gg.get_gamma().back();
+
+    nphot = primary;
+    std::fill(tau.begin(), tau.end(), 0.);
+    generations = 0;
+    converged = false;
+
+    while (generations < max_generations && !converged) {
+        field.set_field(energy, nphot, r, syn.get_volume());
+        pairs.Qggeefunction(gg, r, bfield, field, tau);
+        pairs.gdens_differentiate();
+        gsl_spline_init(spline_gdens, pairs.get_gamma().data(), pairs.get_gdens().data(), ngamma);
+        gsl_spline_init(spline_diff, pairs.get_gamma().data(), pairs.get_gdens_diff().data(),
+                        ngamma);
+
+        syn.cycsyn_spectrum(gmin, gmax, spline_gdens, acc_gdens, spline_diff, acc_diff);
+        ic.reset();
+        ic.cyclosyn_seed(energy, nphot);
+        ic.compton_spectrum(gmin, gmax, spline_gdens, acc_gdens);
+
+        double peak = *std::max_element(nphot.begin(), nphot.end());
+        double change = 0.;
+        for (size_t i = 0; i < size; i++) {
+            double produced = primary[i] + syn.get_nphot()[i] + ic.get_nphot()[i];
+            double escaping = produced / (1. + tau[i]);
+            if (escaping > 1e-10 * peak) {
+                change = std::max(change, std::fabs(escaping - nphot[i]) / escaping);
+            }
+            nphot[i] = escaping;
+        }
+        generations++;
+        converged = change < tolerance;
+    }
+}
+
+}    // namespace kariba
@@ -0,0 +1,33 @@
+#include "kariba/ParticlePool.hpp"
+
+namespace kariba {
+
+ParticlePool::ParticlePool(size_t size)
+    : size(size), thermal(size), mixed(size), kappa(size), powerlaw(size), bknpower(size) {}
+
+Thermal& ParticlePool::get_thermal() {
+    thermal.reset();
+    return thermal;
+}
+
+Mixed& ParticlePool::get_mixed() {
+    mixed.reset();
+    return mixed;
+}
+
+Kappa& ParticlePool::get_kappa() {
+    kappa.reset();
+    return kappa;
+}
+
+Powerlaw& ParticlePool::get_powerlaw() {
+    powerlaw.reset();
+    return powerlaw;
+}
+
+Bknpower& ParticlePool::get_bknpower() {
+    bknpower.reset();
+    return bknpower;
+}
+
+}    // namespace kariba
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <new>
 
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_math.h>
@@ -10,8 +12,58 @@
 
 namespace kariba {
 
-Particles::Particles(size_t size)
-    : p(size, 0.0), ndens(size, 0.0), gamma(size, 0.0), gdens(size, 0.0), gdens_diff(size, 0.0) {}
+void Particles::AlignedDelete::operator()(double* ptr) const {
+    ::operator delete(ptr, std::align_val_t(alignment));
+}
+
+//! Allocate one zero-initialized buffer for all five arrays, and set up the
+//! views into it
+void Particles::allocate(size_t size) {
+    const size_t per_line = alignment / sizeof(double);
+    stride = (size + per_line - 1) / per_line * per_line;
+
+    size_t total = 5 * stride;
+    buffer.reset(static_cast<double*>(
+        ::operator new(total * sizeof(double), std::align_val_t(alignment))));
+    std::fill(buffer.get(), buffer.get() + total, 0.0);
+
+    p = Span<double>(buffer.get(), size);
+    ndens = Span<double>(buffer.get() + stride, size);
+    gamma = Span<double>(buffer.get() + 2 * stride, size);
+    gdens = Span<double>(buffer.get() + 3 * stride, size);
+    gdens_diff = Span<double>(buffer.get() + 4 * stride, size);
+}
+
+Particles::Particles(size_t size) { allocate(size); }
+
+//! Copies get their own buffer; the views are set up to point into it
+Particles::Particles(const Particles& other) : mass_gr(other.mass_gr), mass_kev(other.mass_kev) {
+    allocate(other.p.size());
+    std::copy(other.buffer.get(), other.buffer.get() + 5 * stride, buffer.get());
+}
+
+Particles& Particles::operator=(const Particles& other) {
+    if (this != &other) {
+        mass_gr = other.mass_gr;
+        mass_kev = other.mass_kev;
+        if (p.size() != other.p.size()) {
+            allocate(other.p.size());
+        }
+        std::copy(other.buffer.get(), other.buffer.get() + 5 * stride, buffer.get());
+    }
+    return *this;
+}
+
+//! Clear the number density arrays, without reallocating them, so that an
+//! object can be set up again (e.g. for the next zone of a jet) instead of
+//! constructing a new one. The momentum and Lorentz factor arrays are
+//! overwritten by the set_p methods. Subclasses extend this to restore their
+//! default normalization and mass.
+void Particles::reset() {
+    std::fill(ndens.begin(), ndens.end(), 0.0);
+    std::fill(gdens.begin(), gdens.end(), 0.0);
+    std::fill(gdens_diff.begin(), gdens_diff.end(), 0.0);
+}
 
 //! Simple numerical integrals /w trapeze method
 double Particles::count_particles() {
@@ -74,15 +126,10 @@ void Particles::initialize_pdens() {
 }
 
 void Particles::gdens_differentiate() {
-    std::vector<double> temp;
     size_t size = gdens.size();
 
-    for (size_t i = 0; i < size; i++) {
-        temp.push_back(gdens[i] / (std::pow(gamma[i], 1.)));
-    }
-
     for (size_t i = 0; i < size - 1; i++) {
-        gdens_diff[i] = (temp[i + 1] - temp[i]) /
+        gdens_diff[i] = (gdens[i + 1] / gamma[i + 1] - gdens[i] / gamma[i]) /
                         (mass_gr * std::pow(constants::cee, 2.) * (gamma[i + 1] - gamma[i]));
     }
 
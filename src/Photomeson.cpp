@@ -0,0 +1,30 @@
+#include <gsl/gsl_spline.h>
+
+#include "kariba/Photomeson.hpp"
+
+namespace kariba {
+
+PhotomesonTable::PhotomesonTable(const double* xeta, const double* s, const double* delta,
+                                 const double* Beta, size_t size) {
+    spline_s = gsl_spline_alloc(gsl_interp_cspline, size);
+    spline_delta = gsl_spline_alloc(gsl_interp_cspline, size);
+    spline_Beta = gsl_spline_alloc(gsl_interp_cspline, size);
+
+    gsl_spline_init(spline_s, xeta, s, size);
+    gsl_spline_init(spline_delta, xeta, delta, size);
+    gsl_spline_init(spline_Beta, xeta, Beta, size);
+}
+
+PhotomesonTable::~PhotomesonTable() {
+    gsl_spline_free(spline_s);
+    gsl_spline_free(spline_delta);
+    gsl_spline_free(spline_Beta);
+}
+
+void PhotomesonTable::eval(double xeta, double& s, double& delta, double& Beta) const {
+    s = gsl_spline_eval(spline_s, xeta, nullptr);
+    delta = gsl_spline_eval(spline_delta, xeta, nullptr);
+    Beta = gsl_spline_eval(spline_Beta, xeta, nullptr);
+}
+
+}    // namespace kariba
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "kariba/PhotonField.hpp"
+#include "kariba/constants.hpp"
+
+namespace kariba {
+
+PhotonField::~PhotonField() { gsl_spline_free(spline); }
+
+PhotonField::PhotonField(size_t size)
+    : energy(size, 0.), freq(size, 0.), density(size, 0.), log_density(size, -100.), r(0.),
+      vol(0.) {
+    spline = gsl_spline_alloc(gsl_interp_steffen, size);
+}
+
+void PhotonField::set_field(const std::vector<double>& en, const std::vector<double>& lum,
+                            double _r, double _vol) {
+    size_t nphot = energy.size();
+    if (en.size() < nphot || lum.size() < nphot) {
+        std::cerr << "Photon field of size " << nphot << " set from " << en.size()
+                  << " energies and " << lum.size() << " luminosities!" << std::endl;
+        exit(1);
+    }
+    r = _r;
+    vol = _vol;
+    for (size_t k = 0; k < nphot; k++) {
+        energy[k] = en[k];
+        freq[k] = en[k] / constants::herg;    // Hz from erg
+        density[k] = lum[k] * (r / constants::cee /
+                               (constants::herg * constants::herg * freq[k] * vol));    // #/cm3/erg
+        log_density[k] = density[k] > 0. ? std::log10(density[k]) : -100.;
+    }
+    gsl_spline_init(spline, freq.data(), density.data(), nphot);
+}
+
+//! The field is zero outside its frequencies, and so before it is set, with
+//! a floor that keeps the logarithms of the integrands finite
+double PhotonField::density_at(double nu, gsl_interp_accel* acc) const {
+    if (nu < freq.front() || nu > freq.back()) {
+        return 1e-100;
+    }
+    return gsl_spline_eval(spline, nu, acc);
+}
+
+TargetSpectrum::~TargetSpectrum() { gsl_spline_free(spline); }
+
+TargetSpectrum::TargetSpectrum(size_t size)
+    : lx(size, 0.), lL(size, -100.), dL(size, 0.), uniform(false), dlx(0.) {
+    spline = gsl_spline_alloc(gsl_interp_akima, size);
+}
+
+void TargetSpectrum::set_spectrum(const std::vector<double>& en, const std::vector<double>& lum) {
+    size_t ntarg = lx.size();
+    if (en.size() < ntarg || lum.size() < ntarg) {
+        std::cerr << "Target spectrum of size " << ntarg << " set from " << en.size()
+                  << " energies and " << lum.size() << " luminosities!" << std::endl;
+        exit(1);
+    }
+    for (size_t k = 0; k < ntarg; k++) {
+        lx[k] = std::log10(en[k] / constants::emerg);
+        lL[k] = lum[k] == 0. ? -100. : std::log10(lum[k]);
+    }
+    // The Akima interpolation is a cubic Hermite one, fixed by the values and
+    // slopes at the nodes
+    gsl_spline_init(spline, lx.data(), lL.data(), ntarg);
+    for (size_t k = 0; k < ntarg; k++) {
+        dL[k] = gsl_spline_eval_deriv(spline, lx[k], nullptr);
+    }
+
+    dlx = (lx[ntarg - 1] - lx[0]) / static_cast<double>(ntarg - 1);
+    uniform = true;
+    for (size_t k = 1; k < ntarg - 1 && uniform; k++) {
+        uniform = std::fabs(lx[k] - lx[0] - static_cast<double>(k) * dlx) < 1e-6 * dlx;
+    }
+}
+
+double TargetSpectrum::interpolate(size_t k, double logx) const {
+    double h = lx[k + 1] - lx[k];
+    double t = (logx - lx[k]) / h;
+    double t2 = t * t, t3 = t2 * t;
+    return (2. * t3 - 3. * t2 + 1.) * lL[k] + (t3 - 2. * t2 + t) * h * dL[k] +
+           (3. * t2 - 2. * t3) * lL[k + 1] + (t3 - t2) * h * dL[k + 1];
+}
+
+void TargetSpectrum::add(const std::vector<double>& en, std::vector<double>& lum,
+                         size_t nphot) const {
+    size_t ntarg = lx.size();
+    size_t k = 0;
+    for (size_t i = 0; i < nphot; i++) {
+        double logx = std::log10(en[i] / constants::emerg);
+        if (logx < lx[0] || logx > lx[ntarg - 5]) {
+            continue;
+        }
+        while (k + 2 < ntarg && lx[k + 1] <= logx) {
+            k++;
+        }
+        lum[i] += std::max(1.e-200, std::pow(10., interpolate(k, logx)));
+    }
+}
+
+void TargetSpectrum::add_log_grid(double en_min, double en_max, std::vector<double>& lum,
+                                  size_t nphot) const {
+    size_t ntarg = lx.size();
+    double lmin = std::log10(en_min / constants::emerg);
+    double step = 0.;    // a single photon is at en_min
+    if (nphot > 1) {
+        step = (std::log10(en_max / constants::emerg) - lmin) / static_cast<double>(nphot - 1);
+    }
+    size_t k = 0;
+    for (size_t i = 0; i < nphot; i++) {
+        double logx = lmin + static_cast<double>(i) * step;
+        if (logx < lx[0] || logx > lx[ntarg - 5]) {
+            continue;
+        }
+        if (uniform) {
+            k = std::min(static_cast<size_t>((logx - lx[0]) / dlx), ntarg - 2);
+        } else {
+            while (k + 2 < ntarg && lx[k + 1] <= logx) {
+                k++;
+            }
+        }
+        lum[i] += std::max(1.e-200, std::pow(10., interpolate(k, logx)));
+    }
+}
+
+}    // namespace kariba
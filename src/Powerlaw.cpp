@@ -1,12 +1,15 @@
+#include <algorithm>
 #include <cmath>
-#include <fstream>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_math.h>
 
+#include "kariba/Diagnostics.hpp"
 #include "kariba/Electrons.hpp"
+#include "kariba/GammaGamma.hpp"
 #include "kariba/Particles.hpp"
 #include "kariba/Powerlaw.hpp"
 #include "kariba/constants.hpp"
@@ -14,7 +17,11 @@
 namespace kariba {
 
 //! Class constructor to initialize object
-Powerlaw::Powerlaw(size_t size) : Particles(size) {
+Powerlaw::Powerlaw(size_t size) : Particles(size) { reset(); }
+
+void Powerlaw::reset() {
+    Particles::reset();
+
     plnorm = 1.;
 
     mass_gr = constants::emgm;
@@ -194,8 +201,6 @@ void Powerlaw::ProtonTimescales(double& logdgp, double fsc, double f_beta, doubl
     double EpTeV;      // energy of the proton in TeV
     double gp;         // Lorentz factor of non-thermal protons
 
-    std::ofstream timescalesFile;
-
     Tacc0 = 1. / (3. * fsc / 4. * constants::charg * constants::cee * bfield);    // acceleration
     double Tesc = r / (f_beta * constants::cee);                                  // proton escape
     double Tpp = 1. / (constants::sigmapp * pp_targets * constants::cee);         // pp
@@ -229,7 +234,8 @@ void Powerlaw::ProtonTimescales(double& logdgp, double fsc, double f_beta, doubl
     if (infosw >= 2) {
         std::string filepath =
             outputConfiguration + "/Output/Particles/timescales_" + source + ".dat";
-        timescalesFile.open(filepath, std::ios::app);
+        Diagnostics::Table& timescales =
+            diagnostics().table(filepath, {13, 13, 13, 13, 13, 13, 15});
         for (size_t i = 0; i < gamma.size(); i++) {
             gp = std::pow(10., (std::log10(gpmin) + static_cast<double>(i) * logdgp));
             betap = sqrt(gp * gp - 1.) / gp;
@@ -245,17 +251,11 @@ void Powerlaw::ProtonTimescales(double& logdgp, double fsc, double f_beta, doubl
                     : 1.e100;
             Tpp = 1. / (constants::Kpp * constants::mbarn * sinel * pp_targets * constants::cee);
 
-            timescalesFile << std::left << std::setw(13) << z / r_g << std::setw(13) << gp
-                           << std::setw(13)
-                           << Tacc0 * mass_gr * constants::cee * constants::cee * gp
-                           << std::setw(13) << tescape << std::setw(13)
-                           << Tsynp0 /
-                                  (mass_gr * constants::cee * constants::cee * gp * betap * betap)
-                           << std::setw(13) << Tpp << std::setw(15)
-                           << Tpg0 / (mass_gr * constants::cee * constants::cee) / gp;
-            timescalesFile << std::endl;
+            timescales.add_row(
+                {z / r_g, gp, Tacc0 * mass_gr * constants::cee * constants::cee * gp, tescape,
+                 Tsynp0 / (mass_gr * constants::cee * constants::cee * gp * betap * betap), Tpp,
+                 Tpg0 / (mass_gr * constants::cee * constants::cee) / gp});
         }
-        timescalesFile.close();
         check_secondary_charged_syn(bfield, gpmax);
     }
 }
@@ -405,46 +405,34 @@ void Powerlaw::set_gdens(double& plfrac_p, double Up, double protdens) {
 }
 
 //! Function that produces the secondary electrons from pp
-void Powerlaw::set_pp_elecs(gsl_interp_accel* acc_Jp, gsl_spline* spline_Jp, double ntot_prot,
+void Powerlaw::set_pp_elecs(gsl_interp_accel* /*acc_Jp*/, gsl_spline* spline_Jp, double ntot_prot,
                             double nwind, double plfrac, double gammap_min, double Ep_max,
                             double bfield, double r) {
+    double Epcode_max = Ep_max * constants::erg * 1.e-12;    // The proton energy in TeV
+    set_pp_elecs(PPCollisionRate(gammap_min, Epcode_max, spline_Jp), ntot_prot, nwind, plfrac,
+                 bfield, r);
+}
+
+void Powerlaw::set_pp_elecs(const PPCollisionRate& rate, double ntot_prot, double nwind,
+                            double plfrac, double bfield, double r,
+                            const HadronicConstants& hadronic) {
 
-    double ntilde = multiplicity(pspec);    // The number of produced pions for
-                                            // a given proton distribution
+    double ntilde = hadronic.ntilde_leptons(pspec);    // The number of produced pions for
+                                                       // a given proton distribution
     double pp_targets = target_protons(ntot_prot, nwind, plfrac);
-    double Epcode_max = Ep_max * constants::erg * 1.e-12;    // The proton energy in TeV
+    double Epcode_max = rate.get_Epcode_max();    // The proton energy in TeV
 
-    const size_t N = 60;                        // The number of steps of the secondary particle
-                                                // (e.g., pion) energy.
-    const double gmin = 1.002;                  // the min Lorentz factor of the secondary
-    double gmax = Ep_max / constants::emerg;    // the max Lorentz factor of the secondary
-    double Ep;                                  // the energy of the proton
+    const size_t N = 60;          // The number of steps of the secondary particle
+                                  // (e.g., pion) energy.
+    const double gmin = 1.002;    // the min Lorentz factor of the secondary
+    double gmax = Epcode_max / (constants::erg * 1.e-12) /
+                  constants::emerg;    // the max Lorentz factor of the secondary
     double Bprob;    // Energy distribution of sec electrons for arbitrary pion
                      // distribution
     double xmin = 1.e-3,
            xmax = 1.;    // Min/Max sec particle energy in proton energy
-    double ymin, ymax, dy,
-        y;                    // The exponent of min and max from above, and the step.
-    double Ee;                // energy of secondary electrons in TeV
-    double Epimin, Epimax;    // Min/Max pion energy in TeV for the integral
-                              // over all pion energies.
-    double lEpi;              // std::log10 of pion energy in TeV
-    double dw;                // The logarithmic step with which the pion energy increases
-    double sum;               // For the integral over all pion energies.
-    double sinel;             // The inelastic part of the total cross-section of pp
-                              // collisions.
-    double qpi;               // The production rate of pions.
-    double Jp;                // The number of non-thermal protons/cm3/TeV
-    double Fespec;            // Spectrum of sec electrons from pion decay eq62 from
-                              // Kelner et al. 2006
-    double Fpi;               // eq. 78 from Kelner et al. 2006, the emissivity of electrons
-    double Phie;              // Φ_e the energy spectral distribution in #/cm3/TeV/sec for
-                              // secondary e
-    double fe;                // The energy distribution/probability f_e of electrons
-    double tchar;             // characteristic timescale of electron distribution
-    double beta_elec;         // beta veloscity of electron
-    double tesc;              // escape timescale
-    double tsyne;             // electron synchrotron timescale
+    double ymin, ymax,
+        dy;                   // The exponent of min and max from above, and the step.
     double transition;        // The transition between delta approximation and
                               // distributions in TeV
 
@@ -452,65 +440,73 @@ void Powerlaw::set_pp_elecs(gsl_interp_accel* acc_Jp, gsl_spline* spline_Jp, dou
     ymax = std::log10(xmax);         // The exponent of the max energy of the secondary particles.
     dy = (ymax - ymin) / (N - 1);    // The step of the above
 
-    Bprob = prob();    // The probability for electron production after charged
-                       // pion decay.
+    Bprob = hadronic.prob;    // The probability for electron production after charged
+                              // pion decay.
 
     transition = 0.16;    // The transition between delta approximation and
                           // distributions.
 
-    // Loop for every electron energy
+    const PPDistributionTable& dist_table = elec_dist_pp_table();
+    const PPKernelTable& spec_table = elec_spec_pp_table();
+
+    // Loop for every electron energy; every energy is independent, and σ_pp Jp
+    // is a shared table
+#pragma omp parallel for schedule(dynamic)
     for (size_t j = 0; j < gamma.size(); j++) {
         gamma[j] =
             std::pow(10., std::log10(gmin) + static_cast<double>(j) * std::log10(gmax / gmin) /
                                                  static_cast<double>(gamma.size() - 1));
-        Ee = gamma[j] * constants::emerg * constants::erg * 1.e-12;    // in TeV
+        double Ee = gamma[j] * constants::emerg * constants::erg * 1.e-12;    // in TeV
+        double lEe = std::log10(Ee);
+        double sum = 0.;    // For the integral over all pion energies.
+        double Phie;        // Φ_e the energy spectral distribution in #/cm3/TeV/sec for
+                            // secondary e
         if (Ee < transition) {
-            Epimin = Ee + constants::mpionTeV * constants::mpionTeV / (4. * Ee);
-            Epimax = 1.e6;
-            dw = (std::log10(Epimax / Epimin)) / (N - 1);
-            sum = 0.;
+            double Epimin = Ee + constants::mpionTeV * constants::mpionTeV / (4. * Ee);
+            double Epimax = 1.e6;
+            // The logarithmic step with which the pion energy increases
+            double dw = (std::log10(Epimax / Epimin)) / (N - 1);
+            double lEpimin = std::log10(Epimin);
             for (size_t i = 0; i < N; i++) {
-                lEpi = std::log10(Epimin) +
-                       static_cast<double>(i) * dw;    // The exponent of the pion energy.
-                Ep = constants::mprotTeV +
-                     std::pow(10., lEpi) / constants::Kpi;    // The mass of the proton in TeV.
-                sinel = sigma_pp(Ep);
-                Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                qpi = 2. * ntilde / constants::Kpi * sinel * Jp;
-                fe = elec_dist_pp(std::log10(Ee), lEpi);    // eq36 KAB16
+                double lEpi = lEpimin +
+                              static_cast<double>(i) * dw;    // The exponent of the pion energy.
+                double Ep = constants::mprotTeV +
+                            std::pow(10., lEpi) / constants::Kpi;    // The energy of the proton
+                double qpi = 2. * ntilde / constants::Kpi * rate.eval(Ep, std::log10(Ep));
+                double fe = dist_table.eval(lEe, lEpi);    // eq36 KAB16
                 //				Fpi = qpi*std::pow(10.,w)/ sqrt(
                 // std::pow(10.,(2.*w))- mpionTeV*mpionTeV)*fe*Bprob; Use the
                 // expression below because the above makes a spike at around
                 // 1e8eV (disc. wiht Maria)
-                Fpi = qpi * std::pow(10., lEpi) / sqrt(std::pow(10., (2. * lEpi))) * fe *
-                      Bprob /**1.5*/;
+                double Fpi = qpi * std::pow(10., lEpi) / sqrt(std::pow(10., (2. * lEpi))) * fe *
+                             Bprob /**1.5*/;
                 sum += dw * (Fpi);
             }
             Phie = constants::cee * pp_targets * sum * 1.e-27 *
                    std::log(10.);    // eq 78 in #/cm3/TeV/sec
         } else if ((Ee >= transition) && (Ee <= Epcode_max)) {
-            sum = 0.;
             for (size_t i = 0; i < N; i++) {    // The loop over all pion energies.
-                y = ymin + static_cast<double>(i) * dy;
-                Ep = std::pow(10., (std::log10(Ee) - y));    // Proton enrergy in TeV.
+                double y = ymin + static_cast<double>(i) * dy;
+                double lEp = lEe - y;
+                double Ep = std::pow(10., lEp);    // Proton enrergy in TeV.
                 if (Ep <= Epcode_max) {
-                    sinel = sigma_pp(Ep);
-                    Jp = proton_dist(gammap_min, Ep, Epcode_max, spline_Jp, acc_Jp);
-                    Fespec = elec_spec_pp(Ep, y);
-                    sum += dy * (sinel * Jp * Fespec);
+                    // Spectrum of sec electrons from pion decay eq62 from Kelner et al. 2006
+                    double Fespec = spec_table.eval(lEp, y);
+                    sum += dy * (rate.eval(Ep, lEp) * Fespec);
                 }
-                Phie = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
             }
+            Phie = constants::cee * pp_targets * sum * 1.e-27 * std::log(10.);
         } else {
             Phie = 1.e-50;
         }
 
-        beta_elec = sqrt(gamma[j] * gamma[j] - 1.) / gamma[j];
-        tesc = r / (beta_elec * constants::cee);
-        tsyne = 6. * constants::pi * constants::emerg /
-                (constants::sigtom * constants::cee * bfield * bfield * gamma[j] * beta_elec *
-                 beta_elec);
-        tchar = std::pow(1. / tsyne + 1. / tesc, -1.);
+        double beta_elec = sqrt(gamma[j] * gamma[j] - 1.) / gamma[j];    // beta of electron
+        double tesc = r / (beta_elec * constants::cee);                   // escape timescale
+        double tsyne = 6. * constants::pi * constants::emerg /
+                       (constants::sigtom * constants::cee * bfield * bfield * gamma[j] *
+                        beta_elec * beta_elec);    // electron synchrotron timescale
+        // characteristic timescale of electron distribution
+        double tchar = std::pow(1. / tsyne + 1. / tesc, -1.);
 
         gdens[j] = Phie * tchar * Ee / gamma[j];
     }
@@ -538,93 +534,68 @@ void Powerlaw::set_pg_electrons(const std::vector<double>& energy,
 void Powerlaw::Qggeefunction(double r, double vol, double bfield, size_t phot_number,
                              const std::vector<double>& en_perseg,
                              const std::vector<double>& lum_perseg, double gmax) {
-
     double gmin = 1.002;    // the min Lorentz factor of the secondary
-    double ng;              // number density of photons with energy 2gammae (#/cm3/erg)
-    double Eg;              // std::log of energy(emerg) of photon that collides in order to
-                            // produce pairs
-    double x, dx;           // the dimensionless energy of target photon and std::log step
-                            // of the integration
-    double sum;
-    double R_gg;    // production rate of pairs from gg (in cm3/sec)
-    // double *logx		= new double[phot_number]();	//array of
-    // x=std::log10(hv/mec2) double *logNgamma	= new double[phot_number]();
-    // //array of std::log10(Ngamma[#/cm3/erg]) double *Ngamma		= new
-    // double[phot_number]();	//array of Ngamma[#/cm3/erg]
-    std::vector<double> logx;         // array of x=std::log10(hv/mec2)
-    std::vector<double> logNgamma;    // array of std::log10(Ngamma[#/cm3/erg])
-    std::vector<double> Ngamma;       // array of Ngamma[#/cm3/erg]
-
-    double tchar;        // characteristic timescale
-    double beta_elec;    // beta veloscity of electron
-    double tsyn;         // synchrotron timescale
-    double Rann;         // pair annihilation rate between cold and non-thermal
-                         // electrons
-    double Ne;           // number density (not per erg) of cold/target electrons
-    double Lee_gg;       // losses due to pair annihilation in #/cm3/erg/sec
-    // double *tgg_ee 		= new double[phot_number]();	//photon-photon
-    // annihilation timescale
-    std::vector<double> tgg_ee;    // photon-photon annihilation timescale
-    double tcharg;                 // characteristic timescale for photons
-
-    double Qgg_ee;    // in #/cm3/erg
+    std::vector<double> en(en_perseg.begin(), en_perseg.begin() + phot_number);
+    std::vector<double> tau;
+    GammaGamma gg(gmin, gmax, gamma.size(), en);
+    Qggeefunction(gg, r, vol, bfield, lum_perseg, tau);
+}
 
-    sum = 1.e-100;
-    dx = std::log10(en_perseg[2] / en_perseg[1]);
+//! The same with the γγ rates of gg, whose pair grid must have as many
+//! Lorentz factors as this object; also sets the γγ opacity tau of every
+//! photon, for the internal absorption of the spectrum
+void Powerlaw::Qggeefunction(const GammaGamma& gg, double r, double vol, double bfield,
+                             const std::vector<double>& lum_perseg, std::vector<double>& tau) {
+    const std::vector<double>& en_perseg = gg.get_energy();
+    size_t phot_number = en_perseg.size();
+    std::vector<double> Ngamma(phot_number);    // array of Ngamma[#/cm3/erg]
     for (size_t i = 0; i < phot_number; i++) {
-        logx.push_back(std::log10(en_perseg[i] / constants::emerg));
-        Ngamma.push_back(lum_perseg[i] * r /
-                         (constants::herg * constants::cee * en_perseg[i] * vol));
+        Ngamma[i] = lum_perseg[i] * r / (constants::herg * constants::cee * en_perseg[i] * vol);
         if (Ngamma[i] <= 1.e-100) {
             Ngamma[i] = 1.e-100;
         }
-        logNgamma.push_back(std::log10(Ngamma[i]));
-        sum += en_perseg[i] * std::log(10.) * dx * Ngamma[i];
     }
+    pairs_from_photons(gg, r, bfield, Ngamma, tau);
+}
 
-    for (size_t i = 0; i < phot_number; i++) {
-        x = std::pow(10., logx[i]);
-        if (x <= 1.) {    // for values higher than one the photons are
-                          // considered merely targets
-            tgg_ee[i] = 1.e100;
-        } else {
-            R_gg = constants::sigtom * constants::cee * .652 * (x * x - 1.) / std::pow(x, 3) *
-                   std::log(x);
-            tgg_ee[i] = r / (constants::cee * .652 * (x * x - 1.) / std::pow(x, 3) * std::log(x));
-        }
+void Powerlaw::Qggeefunction(const GammaGamma& gg, double r, double bfield,
+                             const PhotonField& field, std::vector<double>& tau) {
+    if (field.get_energy() != gg.get_energy()) {
+        std::cerr << "Photon field of " << field.size() << " energies for a γγ grid of "
+                  << gg.get_energy().size() << " photons!" << std::endl;
+        exit(1);
+    }
+    std::vector<double> Ngamma(field.get_density());    // array of Ngamma[#/cm3/erg]
+    for (double& n : Ngamma) {
+        n = std::max(n, 1.e-100);
+    }
+    pairs_from_photons(gg, r, bfield, Ngamma, tau);
+}
 
-        // tcharg = std::pow(constants::cee / r + 1. / tgICS + 1. / tgg_ee[i], -1);
-        tcharg = std::pow(constants::cee / r + 1. / tgg_ee[i], -1);
-        Ngamma[i] *= tcharg / tgg_ee[i];    // photons taken into account for γγ->ee
-        logNgamma[i] = std::log10(Ngamma[i]);
+void Powerlaw::pairs_from_photons(const GammaGamma& gg, double r, double bfield,
+                                  const std::vector<double>& Ngamma, std::vector<double>& tau) {
+    if (gg.get_gamma().size() != gamma.size()) {
+        std::cerr << "Pair grid of " << gg.get_gamma().size()
+                  << " Lorentz factors for a particle array of size " << gamma.size()
+                  << std::endl;
+        exit(1);
     }
 
-    // We interpolate all over the photons added above
-    gsl_interp_accel* acc_lNg = gsl_interp_accel_alloc();
-    gsl_spline* spline_lNg = gsl_spline_alloc(gsl_interp_steffen, phot_number);
-    gsl_spline_init(spline_lNg, logx.data(), logNgamma.data(), phot_number);
+    double tchar;        // characteristic timescale
+    double beta_elec;    // beta veloscity of electron
+    double tsyn;         // synchrotron timescale
+    double Rann;         // pair annihilation rate between cold and non-thermal
+                         // electrons
+    double Ne;           // number density (not per erg) of cold/target electrons
+    double Lee_gg;       // losses due to pair annihilation in #/cm3/erg/sec
 
-    for (size_t i = 0; i < gamma.size(); i++) {
-        gamma[i] =
-            std::pow(10., std::log10(gmin) + static_cast<double>(i) * std::log10(gmax / gmin) /
-                                                 static_cast<double>(gamma.size() - 1));
-        Eg = std::log10(2. * gamma[i]);    // 2γ from MK95
+    std::vector<double> Qgg_ee;    // in #/cm3/erg/sec
 
-        if (Eg >= logx[1] && Eg <= logx[phot_number - 1]) {
-            ng = std::pow(10., gsl_spline_eval(spline_lNg, Eg,
-                                               acc_lNg));    // n_γ(2γ) from MK95
-        } else {
-            ng = 1.e-200;
-        }
+    gg.opacity(Ngamma, r, tau);
+    gg.pair_injection(Ngamma, Qgg_ee);
 
-        sum = 0.;
-        for (size_t j = 0; j < phot_number; j++) {    // eq.57 from MK95 in units of [n]=#/cm3/erg
-            x = std::pow(10., logx[j]);
-            R_gg = production_rate(gamma[i], x);
-            sum += dx * std::pow(10., logNgamma[j] + logx[j]) * std::log(10.) * R_gg;
-            // ln10 and the extra x term because of std::log integration
-        }
-        Qgg_ee = 4. * ng * sum * constants::emerg;    // #/cm3/erg/sec
+    for (size_t i = 0; i < gamma.size(); i++) {
+        gamma[i] = gg.get_gamma()[i];
 
         beta_elec = sqrt(gamma[i] * gamma[i] - 1.) / gamma[i];
         tsyn = 6. * constants::pi * constants::emerg /
@@ -632,17 +603,15 @@ void Powerlaw::Qggeefunction(double r, double vol, double bfield, size_t phot_nu
                 beta_elec);
         tchar = std::pow(constants::cee / r + 1. / tsyn, -1);
 
-        Qgg_ee *= tchar;    // #/cm3/erg of pairs after photon-photon
+        Qgg_ee[i] *= tchar;    // #/cm3/erg of pairs after photon-photon
 
         Rann = 3. * constants::sigtom * constants::cee / (8. * gamma[i]) *
                (std::pow(gamma[i], -0.5) + std::log(gamma[i]));
-        Ne = Qgg_ee * gamma[i] * constants::emerg;
-        Lee_gg = Ne * Rann * Qgg_ee * tchar;    //(non-)cooled pairs collide with cold pairs
-        gdens[i] = (Qgg_ee - Lee_gg) * constants::emerg;    // #/cm3/γ
+        Ne = Qgg_ee[i] * gamma[i] * constants::emerg;
+        Lee_gg = Ne * Rann * Qgg_ee[i] * tchar;    //(non-)cooled pairs collide with cold pairs
+        // no pairs are left if they annihilate faster than they are injected
+        gdens[i] = std::max(Qgg_ee[i] - Lee_gg, 0.) * constants::emerg;    // #/cm3/γ
     }
-
-    // we free the space occupied for interpolation
-    gsl_spline_free(spline_lNg), gsl_interp_accel_free(acc_lNg);
 }
 
 //! simple method to check quantities.
@@ -1,7 +1,9 @@
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include <gsl/gsl_integration.h>
+#include <gsl/gsl_spline2d.h>
 
 #include "kariba/ShSDisk.hpp"
 #include "kariba/constants.hpp"
@@ -11,7 +13,9 @@ namespace kariba {
 //! Constructor for the disk. No input parameters because the sized of the arrays
 //! is set automatically, and every other property needs to be handled by the
 //! setters below
-ShSDisk::ShSDisk(size_t size) : Radiation(size) {}    // size = 50 in the declaration
+ShSDisk::ShSDisk(size_t size) : Radiation(size) {    // size = 50 in the declaration
+    covered = 0.;
+}
 
 //! return SD spectrum over a given radius, frequency to be integrated over
 //! radius
@@ -36,28 +40,139 @@ double disk_int(double lr, void* pars) {
     return 2. * constants::pi * std::pow(r, 2.) * bb;
 }
 
-void ShSDisk::disk_spectrum() {
+// Integrand of the disk kernel over ln ρ, with the Rayleigh-Jeans limit of
+// disk_int
+static double kernel_int(double lrho, void* pars) {
+    double x = *static_cast<double*>(pars);
+    double rho = std::exp(lrho);
+    double fac = x * std::pow(rho, 0.75);
+    double bb = fac < 1.e-3 ? 1. / fac : 1. / std::expm1(fac);
+    return rho * rho * bb;
+}
+
+//! The grid covers hν/kTin = 1e-9 to 10^2.5, and radii ratios of 10^0.05 to
+//! 1e8; at the lowest x every ring of the largest disk is in the
+//! Rayleigh-Jeans limit. For every x, the integral is accumulated over the
+//! ratios, one interval at a time. The table holds log10(K e^x), which is
+//! smooth where K falls exponentially.
+DiskKernel::DiskKernel() {
+    const size_t nx = 231, nratio = 160;
+    lx.resize(nx);
+    lratio.resize(nratio);
+    lkernel.resize(nx * nratio);
+    for (size_t i = 0; i < nx; i++) {
+        lx[i] = -9. + 0.05 * static_cast<double>(i);
+    }
+    for (size_t j = 0; j < nratio; j++) {
+        lratio[j] = 0.05 + 0.05 * static_cast<double>(j);
+    }
+
+    gsl_integration_workspace* w = gsl_integration_workspace_alloc(200);
+    for (size_t i = 0; i < nx; i++) {
+        double x = std::pow(10., lx[i]);
+        gsl_function F;
+        F.function = &kernel_int;
+        F.params = &x;
+        double sum = 0., lower = 0., result, error;
+        for (size_t j = 0; j < nratio; j++) {
+            double upper = lratio[j] * std::log(10.);
+            // the outer rings add nothing at high x, so the accuracy is relative
+            // to the integral so far
+            gsl_integration_qag(&F, lower, upper, 1e-12 * sum, 1e-10, 200, GSL_INTEG_GAUSS31, w,
+                                &result, &error);
+            sum += result;
+            lower = upper;
+            lkernel[j * nx + i] = std::log10(x * x * x * sum) + x / std::log(10.);
+        }
+    }
+    gsl_integration_workspace_free(w);
+
+    spline = gsl_spline2d_alloc(gsl_interp2d_bicubic, nx, nratio);
+    gsl_spline2d_init(spline, lx.data(), lratio.data(), lkernel.data(), nx, nratio);
+}
+
+DiskKernel::~DiskKernel() { gsl_spline2d_free(spline); }
+
+bool DiskKernel::contains(double ratio) const {
+    double l = std::log10(ratio);
+    return l >= lratio.front() && l <= lratio.back();
+}
+
+double DiskKernel::eval(double x, double ratio, gsl_interp_accel* acc_x,
+                        gsl_interp_accel* acc_r) const {
+    double l = std::log10(x), lr = std::log10(ratio);
+    double lk;
+    if (l < lx.front()) {
+        lk = gsl_spline2d_eval(spline, lx.front(), lr, acc_x, acc_r) + 2. * (l - lx.front());
+    } else if (l > lx.back()) {
+        lk = gsl_spline2d_eval(spline, lx.back(), lr, acc_x, acc_r) + 2. * (l - lx.back());
+    } else {
+        lk = gsl_spline2d_eval(spline, l, lr, acc_x, acc_r);
+    }
+    return std::pow(10., lk) * std::exp(-x);
+}
+
+const DiskKernel& disk_kernel() {
+    static const DiskKernel kernel;
+    return kernel;
+}
+
+//! The luminosity emitted at energy en, scaled from the disk kernel unless
+//! the ratio of the radii is outside its table, in which case it is
+//! integrated over the radius
+double ShSDisk::emitted(double en, gsl_interp_accel* acc_x, gsl_interp_accel* acc_r) const {
+    const DiskKernel& kernel = disk_kernel();
+    if (kernel.contains(z / r)) {
+        double kT = constants::kboltz * Tin;
+        double norm = 4. * constants::pi * r * r * kT * kT * kT /
+                      (constants::herg * constants::herg * constants::cee * constants::cee);
+        return norm * kernel.eval(en / kT, z / r, acc_x, acc_r);
+    }
+
     double result, error;
+    gsl_integration_workspace* w1;
+    w1 = gsl_integration_workspace_alloc(100);
+    gsl_function F1;
+    auto F1params = DiskObsParams{Tin, r, en / constants::herg};
+    F1.function = &disk_int;
+    F1.params = &F1params;
+    gsl_integration_qag(&F1, std::log(r), std::log(z), 0, 1e-2, 100, 2, w1, &result, &error);
+    gsl_integration_workspace_free(w1);
+    return result;
+}
 
+void ShSDisk::disk_spectrum() {
+    gsl_interp_accel* acc_x = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_r = gsl_interp_accel_alloc();
     for (size_t k = 0; k < en_phot_obs.size(); k++) {
-        gsl_integration_workspace* w1;
-        w1 = gsl_integration_workspace_alloc(100);
-        gsl_function F1;
-        auto F1params = DiskObsParams{Tin, r, en_phot_obs[k] / constants::herg};
-        F1.function = &disk_int;
-        F1.params = &F1params;
-        gsl_integration_qag(&F1, std::log(r), std::log(z), 0, 1e-2, 100, 2, w1, &result, &error);
-        gsl_integration_workspace_free(w1);
-
+        double result = emitted(en_phot_obs[k], acc_x, acc_r);
         num_phot[k] = result;
         num_phot_obs[k] = cos(angle) * result;
     }
+    gsl_interp_accel_free(acc_x);
+    gsl_interp_accel_free(acc_r);
+    covered = 0.;
+}
+
+void ShSDisk::add_spectrum(const std::vector<double>& en, std::vector<double>& lum) const {
+    double emin = en_phot_obs.front(), emax = en_phot_obs.back();
+    double fac = cos(angle) * (1. - covered);
+    gsl_interp_accel* acc_x = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_r = gsl_interp_accel_alloc();
+    for (size_t k = 0; k < en.size(); k++) {
+        if (en[k] > emin && en[k] < emax) {
+            lum[k] = lum[k] + fac * emitted(en[k], acc_x, acc_r);
+        }
+    }
+    gsl_interp_accel_free(acc_x);
+    gsl_interp_accel_free(acc_r);
 }
 
 //! this method removes a fraction f from the observed disk luminosity, assuming
 //! that it was absorbed and reprocessed into some other unspecified radiative
 //! mechanism
 void ShSDisk::cover_disk(double f) {
+    covered = 1. - (1. - covered) * (1. - f);
     for (size_t k = 0; k < num_phot_obs.size(); k++) {
         num_phot_obs[k] = num_phot_obs[k] * (1. - f);
     }
@@ -2,15 +2,19 @@
 #include <iostream>
 
 #include <gsl/gsl_math.h>
-#include <gsl/gsl_sf_bessel.h>
 
+#include "kariba/Bessel.hpp"
 #include "kariba/Thermal.hpp"
 #include "kariba/constants.hpp"
 
 namespace kariba {
 
 //! Class constructor to initialize object
-Thermal::Thermal(size_t size) : Particles(size) {
+Thermal::Thermal(size_t size) : Particles(size) { reset(); }
+
+void Thermal::reset() {
+    Particles::reset();
+
     thnorm = 1.;
 
     mass_gr = constants::emgm;
@@ -57,6 +61,22 @@ void Thermal::set_norm(double n) {
     thnorm = n / (std::pow(mass_gr * constants::cee, 3.) * theta * K2(1. / theta));
 }
 
+//! The average momentum follows from integrating p^3 exp(-gamma/theta), which
+//! gives <p> = 2 m c theta exp(-1/theta) (1 + 3 theta + 3 theta^2) / K2(1/theta).
+//! The scaled Bessel function avoids underflow for cold distributions
+double Thermal::av_p_mj(double T, double m) {
+    double th = (T * constants::kboltz_kev2erg) / (m * constants::cee * constants::cee);
+
+    return 2. * m * constants::cee * th * (1. + 3. * th + 3. * th * th) / bessel_k2_scaled(1. / th);
+}
+
+//! <gamma> = 3 theta + K1(1/theta) / K2(1/theta), see e.g. Wright & Hadley (1975)
+double Thermal::av_gamma_mj(double T, double m) {
+    double th = (T * constants::kboltz_kev2erg) / (m * constants::cee * constants::cee);
+
+    return 3. * th + bessel_k1_scaled(1. / th) / bessel_k2_scaled(1. / th);
+}
+
 //! Evaluate Bessel function as in old agnjet
 double Thermal::K2(double x) {
     double res;
@@ -64,7 +84,7 @@ double Thermal::K2(double x) {
     if (x < 0.1) {
         res = 2. / x / x;
     } else {
-        res = gsl_sf_bessel_Kn(2, x);
+        res = bessel_k2(x);
     }
 
     return res;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Radiation.hpp"
 
 namespace kariba {
@@ -19,6 +21,9 @@ class BBody : public Radiation {
     void set_temp_hz(double nu);
     void set_lum(double L);
     void bb_spectrum();
+    //! Adds the observed spectrum to the luminosities lum on the energies en
+    //! in erg, within the energy range of the black body, in closed form
+    void add_spectrum(const std::vector<double>& en, std::vector<double>& lum) const;
 
     double temp_kev() const;
     double temp_k() const;
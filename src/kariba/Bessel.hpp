@@ -0,0 +1,25 @@
+#pragma once
+
+namespace kariba {
+
+//! Fast evaluations of the modified Bessel functions of the second kind, for
+//! x > 0. These replace calls to gsl_sf_bessel_Kn in the normalization of
+//! relativistic thermal (Maxwell-Juttner) distributions, which are computed
+//! for every thermal population in every zone.
+//!
+//! The functions use the polynomial approximations of Abramowitz & Stegun
+//! (1964), eqs. 9.8.1-9.8.8, with K_2 obtained from the recurrence
+//! K_2(x) = K_0(x) + 2 K_1(x) / x. The relative error is below ~1e-6 over the
+//! full range of x, which is well below the accuracy of the momentum grids.
+double bessel_k0(double x);
+double bessel_k1(double x);
+double bessel_k2(double x);
+
+//! Exponentially scaled versions, exp(x) K_n(x). These do not underflow for
+//! large x (cold distributions), and are the ones to use for ratios of Bessel
+//! functions
+double bessel_k0_scaled(double x);
+double bessel_k1_scaled(double x);
+double bessel_k2_scaled(double x);
+
+}    // namespace kariba
@@ -14,6 +14,8 @@ class Bknpower : public Particles {
   public:
     Bknpower(size_t size);
 
+    void reset() override;
+
     void set_p(double min, double brk, double ucom, double bfield, double betaeff, double r,
                double fsc);
     void set_p(double min, double brk, double gmax);
@@ -2,6 +2,7 @@
 
 #include <gsl/gsl_spline2d.h>
 
+#include "PhotonField.hpp"
 #include "Radiation.hpp"
 
 namespace kariba {
@@ -18,6 +19,8 @@ class Compton : public Radiation {
     std::vector<double> seed_urad;     //!< array of seed photon number density in log10(#/erg/cm^3)
     std::vector<double>
         iter_urad;    //!< array of iterated photon number density in log10(#/erg/cm^3)
+    std::vector<double> seed_field;    //!< seed photon number density in #/erg/cm^3 of the
+                                       //!< fields added so far, summed in linear space
 
     gsl_spline* seed_ph;           //!< interpolation of photon field array seed_urad
     gsl_interp_accel* acc_seed;    //!< accelerator for above spline
@@ -49,6 +52,22 @@ class Compton : public Radiation {
     void shsdisk_seed(const std::vector<double>& seed_arr, double tin, double rin, double rout,
                       double h, double z);
 
+    //! Same as the methods above, but only add the field to the seed photons;
+    //! init_seed then sets up the seed field for the scattering once, after
+    //! all fields are added
+    void add_cyclosyn_seed(const std::vector<double>& seed_arr,
+                           const std::vector<double>& seed_lum);
+    void add_bb_seed_k(const std::vector<double>& seed_arr, double Urad, double Tbb);
+    void add_bb_seed_kev(const std::vector<double>& seed_arr, double Urad, double Tbb);
+    void add_shsdisk_seed(const std::vector<double>& seed_arr, double tin, double rin,
+                          double rout, double h, double z);
+    //! Adds the target photon field of the region. Its density counts the
+    //! photons that escape the volume of the region in r/c, while the seed
+    //! field counts those crossing its cross-section, as add_cyclosyn_seed; it
+    //! is rescaled by vol / (π r^3) of the field to n = L / (c h E π r^2)
+    void add_field_seed(const PhotonField& field);
+    void init_seed();
+
     void set_frequency(double numin, double numax);
     void set_tau(double n, double gam);
     void set_tau(double _tau);
@@ -61,6 +80,11 @@ class Compton : public Radiation {
 
     double get_ypar() const { return ypar; };
 
+    //! The seed energies in erg, and the photon number density in #/erg/cm^3
+    //! of the fields added to the seed field so far
+    const std::vector<double>& get_seed_energy() const { return seed_energ; }
+    const std::vector<double>& get_seed_field() const { return seed_field; }
+
     void reset();
     void urad_test();
     void test();
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kariba {
+
+//! In-memory tables of the infosw >= 2 output files, written by flush; the
+//! binary format appends the column and row counts and the values to path.bin
+class Diagnostics {
+  public:
+    enum class Format { text, binary };
+
+    class Table {
+      protected:
+        std::vector<int> widths;
+        std::vector<double> values;
+
+        friend class Diagnostics;
+
+      public:
+        explicit Table(std::vector<int> widths) : widths(std::move(widths)) {}
+
+        size_t get_ncolumns() const { return widths.size(); }
+        size_t get_nrows() const { return values.size() / widths.size(); }
+        const std::vector<double>& get_values() const { return values; }
+
+        //! Adds a row, with as many values as columns
+        void add_row(std::initializer_list<double> row);
+    };
+
+  protected:
+    std::map<std::string, Table> tables;
+    Format format;
+    mutable std::mutex mutex;
+
+  public:
+    Diagnostics();
+    ~Diagnostics();
+    Diagnostics(const Diagnostics&) = delete;
+    Diagnostics& operator=(const Diagnostics&) = delete;
+
+    void set_format(Format f) { format = f; }
+    Format get_format() const { return format; }
+
+    //! The table for the file path, created with the given column widths (in
+    //! characters, for the text format) if it does not exist yet; thread-safe,
+    //! but adding rows to one table from several threads is not
+    Table& table(const std::string& path, const std::vector<int>& widths);
+    //! The table for the file path, or nullptr if there is none; thread-safe
+    const Table* find(const std::string& path) const;
+
+    //! Writes all tables to their files and empties them
+    void flush();
+    //! Empties all tables without writing them
+    void clear();
+};
+
+//! The diagnostics sink used by the library, set up on first use. Rows are
+//! only written when it is flushed, so drivers flush it at the end of each
+//! run (as jetmain does); otherwise it is flushed at the end of the program.
+Diagnostics& diagnostics();
+
+}    // namespace kariba
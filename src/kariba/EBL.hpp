@@ -1,9 +1,92 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include <gsl/gsl_spline2d.h>
+
 namespace kariba {
 
+//! The EBL optical depth τ(z, E) over redshifts and photon energies in TeV,
+//! with tau[j * nz + i] at (redshift[i], energy[j]), interpolated bicubically
+class EBLTable {
+  protected:
+    std::vector<double> redshift;
+    std::vector<double> energy;
+    std::vector<double> tau;
+    gsl_spline2d* spline;
+
+  public:
+    EBLTable(std::vector<double> redshift, std::vector<double> energy, std::vector<double> tau);
+    ~EBLTable();
+    EBLTable(const EBLTable&) = delete;
+    EBLTable& operator=(const EBLTable&) = delete;
+
+    const std::vector<double>& get_redshift() const { return redshift; }
+    const std::vector<double>& get_energy() const { return energy; }
+    const std::vector<double>& get_tau() const { return tau; }
+
+    //! τ at redshift z and photon energy E in TeV, inside the table
+    double eval(double z, double E, gsl_interp_accel* acc_z, gsl_interp_accel* acc_E) const;
+};
+
+//! The attenuation exp(-τ(E)) of an EBL model at one redshift, on a grid of
+//! photon energies in erg. Energies outside the table, and all energies for
+//! a redshift outside it, are not attenuated, nor are those with τ < 0.
+class EBLCurve {
+  protected:
+    double redshift;
+    std::vector<double> energy;
+    std::vector<double> attenuation;
+
+  public:
+    EBLCurve(const EBLTable& table, const std::vector<double>& en, double redshift);
+
+    double get_redshift() const { return redshift; }
+    const std::vector<double>& get_energy() const { return energy; }
+    const std::vector<double>& get_attenuation() const { return attenuation; }
+
+    //! Attenuates the luminosities on the energy grid of the curve; those
+    //! below the threshold of the model are left as they are
+    void apply(std::vector<double>& lum) const;
+    //! Same for nrows spectra stored one after the other in spectra (e.g. the
+    //! components of a model, or the samples of a posterior), which are
+    //! attenuated in parallel
+    void apply(std::vector<double>& spectra, size_t nrows) const;
+};
+
+//! The model by Gilmore et al. (2012), set up on first use
+const EBLTable& gilmore_table();
+
+//! Registers an EBL model stored in a table file written by write_ebl_table,
+//! under a name for ebl_model and ebl_curve; the file is only read when the
+//! model is first used. Registering a name again replaces its model. The model
+//! by Gilmore et al. (2012) is built in, as "gilmore".
+void register_ebl_model(const std::string& name, const std::string& path);
+//! The table of a model, loaded on first use; thread-safe
+std::shared_ptr<const EBLTable> ebl_model(const std::string& name);
+
+//! Writes a table in the binary format of the EBL models: the characters
+//! "KEBL", the format version (a 32-bit unsigned integer), the number of
+//! redshifts and energies (64-bit unsigned integers), the redshifts, the
+//! energies and the values of τ as doubles, and an FNV-1a checksum of all
+//! that (a 64-bit unsigned integer), all in the byte order of the machine.
+void write_ebl_table(const EBLTable& table, const std::string& path);
+//! Reads a table written by write_ebl_table, checking its format and checksum
+std::shared_ptr<const EBLTable> read_ebl_table(const std::string& path);
+
+//! The curve of a model for a redshift and an energy grid. Below the redshifts
+//! of the model there is no attenuation, and above them that of the highest
+//! redshift (z = 9 for gilmore, as for ebl_atten_gil). Curves are cached, so
+//! that later calls with the same model, redshift and grid (e.g. when fitting
+//! a source of known redshift) only look them up; thread-safe.
+std::shared_ptr<const EBLCurve> ebl_curve(const std::string& model, const std::vector<double>& en,
+                                          double redshift);
+//! Same as ebl_curve for the model by Gilmore et al. (2012)
+std::shared_ptr<const EBLCurve> gilmore_curve(const std::vector<double>& en, double redshift);
+
 void ebl_atten_gil(const std::vector<double>& en, std::vector<double>& lum, double redshift);
 
-}
+}    // namespace kariba
@@ -2,6 +2,8 @@
 
 #include <gsl/gsl_spline.h>
 
+#include "PPTables.hpp"
+
 namespace kariba {
 
 //! functions for electrons from pp
@@ -9,6 +11,10 @@ double multiplicity(double pspec);
 double prob();
 double elec_dist_pp(double zen, double w);
 double elec_spec_pp(double Ep, double y);
+//! elec_dist_pp and elec_spec_pp tabulated, the latter on the y grid of
+//! Powerlaw::set_pp_elecs; set up on first use
+const PPDistributionTable& elec_dist_pp_table();
+const PPKernelTable& elec_spec_pp_table();
 
 double target_protons(double ntot_prot, double nwind, double plfrac);
 double proton_dist(double gpmin, double Ep, double Epcode_max, gsl_spline* spline_Jp,
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <gsl/gsl_spline2d.h>
+
+namespace kariba {
+
+//! Boost of the energy density of the photons of a shell (the BLR) or ring
+//! (the torus) of radius R in the frame of a jet region at height z = ζ R
+//! with Lorentz factor Γ, in units of δ² U, with U the energy density inside
+//! the shell and δ the Doppler factor of the region (Ghisellini & Tavecchio
+//! 2009). It is 1 inside the shell, c(ζ)/(3β) from ζ = 3 on, with
+//!
+//!     c(ζ) = 2 (1 - β μ1)^3 - (1 - β μ2)^3 - (1 - β)^3,
+//!     μ1 = (1 + ζ^-2)^(-1/2), μ2 = (1 - ζ^-2)^(1/2),
+//!
+//! and linear in ζ in between.
+double external_boost(double zeta, double gamma);
+
+//! external_boost beyond ζ = 3, tabulated in log10 over log10 ζ and log10 Γ
+class ExternalBoostTable {
+  protected:
+    std::vector<double> lzeta;     //!< log10 ζ, from log10 3
+    std::vector<double> lgamma;    //!< log10 Γ
+    std::vector<double> lboost;    //!< log10 of the boost, at [j * lzeta.size() + i]
+    gsl_spline2d* spline;
+
+  public:
+    ExternalBoostTable();
+    ~ExternalBoostTable();
+    ExternalBoostTable(const ExternalBoostTable&) = delete;
+    ExternalBoostTable& operator=(const ExternalBoostTable&) = delete;
+
+    //! Whether the table covers ζ and Γ
+    bool contains(double zeta, double gamma) const;
+    double eval(double zeta, double gamma, gsl_interp_accel* acc_z,
+                gsl_interp_accel* acc_g) const;
+};
+
+//! The boost table, set up on first use
+const ExternalBoostTable& external_boost_table();
+
+//! Black body BLR shells and torus of an AGN (Ghisellini & Tavecchio 2009)
+class ExternalField {
+  public:
+    struct Source {
+        double radius;      //!< in cm
+        double udens;       //!< energy density inside the source in erg/cm3
+        double temp;        //!< black body temperature in K
+        double lum;         //!< luminosity in erg/s
+        double fcooling;    //!< fraction of udens in the cooling beyond the source
+    };
+
+  protected:
+    std::vector<Source> sources;
+
+  public:
+    const std::vector<Source>& get_sources() const { return sources; }
+
+    void clear() { sources.clear(); }
+    void add_source(const Source& source) { sources.push_back(source); }
+    //! The BLR reprocessing a fraction f of the disk luminosity lum in erg/s
+    void add_blr(double lum, double f);
+    //! The same, with the BLR split in nshells shells of equal luminosity
+    //! whose radii are log-spaced from rmin to rmax times that of the BLR
+    void add_stratified_blr(double lum, double f, size_t nshells, double rmin, double rmax);
+    //! The torus reprocessing a fraction f of the disk luminosity lum in erg/s
+    void add_torus(double lum, double f);
+
+    //! The comoving energy density in erg/cm3 of source k in a jet region at
+    //! height z with Lorentz factor gamma and Doppler factor delta; its photons
+    //! are those of a black body of temperature delta times that of the source.
+    //! acc_z and acc_g are the caller's accelerators for the boost table.
+    double comoving_udens(size_t k, double z, double gamma, double delta,
+                          gsl_interp_accel* acc_z, gsl_interp_accel* acc_g) const;
+    //! The energy density of all sources for the cooling of the particles in
+    //! the same region
+    double cooling_udens(double z, double gamma, double delta, gsl_interp_accel* acc_z,
+                         gsl_interp_accel* acc_g) const;
+};
+
+}    // namespace kariba
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace kariba {
+
+//! Tabulated γγ pair production rate (Coppi & Blandford 1990) and opacity on
+//! fixed pair and log-spaced photon grids, reused for every photon field
+class GammaGamma {
+  protected:
+    std::vector<double> gamma;     //!< Lorentz factors of the pairs
+    std::vector<double> energy;    //!< photon energies in erg
+
+    //! pair_rates[i * nphot + k] = R(2γ_i x_k) dE_k, and
+    //! photon_rates[j * nphot + k] = R(x_j x_k) dE_k, in cm3 erg/s, with x the
+    //! photon energies in units of mec2 and dE the integration weights
+    std::vector<double> pair_rates;
+    std::vector<double> photon_rates;
+
+    //! The photons of energy 2γ_i, interpolated between photon nodes
+    //! index[i] and index[i]+1 with weight weight[i]; index[i] is the number
+    //! of photons if 2γ_i is outside the photon grid
+    std::vector<size_t> index;
+    std::vector<double> weight;
+
+  public:
+    //! The pairs have ngamma Lorentz factors, log-spaced from gmin to gmax;
+    //! en_phot are the photon energies in erg
+    GammaGamma(double gmin, double gmax, size_t ngamma, const std::vector<double>& en_phot);
+
+    const std::vector<double>& get_gamma() const { return gamma; }
+    const std::vector<double>& get_energy() const { return energy; }
+
+    //! The γγ opacity over a length r of every photon of the grid, in the field
+    //! of photon number densities n in #/cm3/erg
+    void opacity(const std::vector<double>& n, double r, std::vector<double>& tau) const;
+    //! The pair injection rate in #/cm3/erg/s for photon number densities n in
+    //! #/cm3/erg; it is 1e-200 for the pairs whose photons of energy 2γ are
+    //! outside the photon grid
+    void pair_injection(const std::vector<double>& n, std::vector<double>& Q) const;
+};
+
+}    // namespace kariba
@@ -6,6 +6,8 @@ Gamma-rays from neutral pion decay, products of inelastic pp and pγ collisions
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
 
+#include "PPTables.hpp"
+#include "PhotonField.hpp"
 #include "Radiation.hpp"
 
 namespace kariba {
@@ -23,6 +25,9 @@ struct HetagParams {
     gsl_spline* spline_ng;
     double nu_min;
     double nu_max;
+    double s;    // spectrum parameters from the KA08 tables at this η
+    double delta;
+    double Beta;
 };
 
 class Grays : public Radiation {
@@ -32,16 +37,30 @@ class Grays : public Radiation {
     //! Method to set the gamma-rays from pp inelastic interactions. p: pspec_p,
     //! ntot_prot: total proton number density of the jet segment,
     //! ntargets: the number density of external proton density (companion etc),
-    //! plfrac: plfrac_p
+    //! plfrac: plfrac_p. The energy bins are computed in parallel when
+    //! compiled with OpenMP; acc_Jp is not used.
     void set_grays_pp(double p, double gammap_min, double gammap_max, double ntot_prot,
                       double ntargets, double plfrac, gsl_interp_accel* acc_Jp,
                       gsl_spline* spline_Jp);
+    //! The same, with σ_pp Jp from a table that can be shared with the other
+    //! pp products of the same protons
+    void set_grays_pp(double p, double ntot_prot, double ntargets, double plfrac,
+                      const PPCollisionRate& rate,
+                      const HadronicConstants& hadronic = hadronic_constants());
 
+    //! Method to set the gamma-rays from pγ interactions. The energy bins are
+    //! computed in parallel when compiled with OpenMP; acc_Jp is not used, as
+    //! every thread has its own accelerators.
     void set_grays_pg(double gp_min, double gp_max, gsl_interp_accel* acc_Jp, gsl_spline* spline_Jp,
                       std::vector<double>& nu_per_seg, std::vector<double>& ng_per_seg, size_t ne);
+    //! The same on the target photon field of the region, set up by the caller
+    void set_grays_pg(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                      const PhotonField& field);
 };
 
-//! Adds up in the lum_perseg the target photon luminosity (in erg/sec/Hz)
+//! Adds up in the lum_perseg the target photon luminosity (in erg/sec/Hz).
+//! This sets up the target interpolation on every call; TargetSpectrum keeps
+//! it for targets that are added more than once.
 void sum_photons(size_t nphot, std::vector<double>& en_perseg, std::vector<double>& lum_perseg,
                  size_t ntarg, const std::vector<double>& targ_en,
                  const std::vector<double>& targ_lum);
@@ -59,6 +78,8 @@ double sigma_pp(double Ep);
 double proton_dist(double gpmin, double Ep, double Epcode_max, gsl_spline* spline_Jp,
                    gsl_interp_accel* acc_Jp);
 double gspec_pp(double Ep, double y);
+//! gspec_pp tabulated on the y grid of Grays::set_grays_pp, set up on first use
+const PPKernelTable& gspec_pp_table();
 
 //! The following are common for γ rays/electrons/neutrinos from pγ:
 double colliding_protons(gsl_spline* spline_Jp, gsl_interp_accel* acc_Jp, double gp_min,
@@ -67,5 +88,7 @@ double photons_jet(double eta, double Ep, gsl_spline* spline_ng, gsl_interp_acce
                    double nu_min, double nu_max);
 void tables_photomeson_gamma(double& s, double& delta, double& Beta, double xeta);
 double PhiFunc_gamma(double eta, double eta0, double x);
+//! As above, with the spectrum parameters s, δ and B already looked up for η
+double PhiFunc_gamma(double eta, double eta0, double x, double s, double delta, double Beta);
 
 }    // namespace kariba
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace kariba {
+
+//! A vector-valued integrand: sets f[k], k = 0..n-1, at x
+using VectorFunction = void (*)(double x, double* f, void* params);
+
+//! Adaptive integration of several integrands on one common set of
+//! subintervals. This is meant for integrands that share an expensive factor
+//! (e.g. a particle distribution times a photon field) and only differ in a
+//! cheap one, so that the shared factor is evaluated once per node.
+//!
+//! The algorithm is that of gsl_integration_qag with the 15-point
+//! Gauss-Kronrod rule (GSL_INTEG_GAUSS15). The subinterval with the largest
+//! error, relative to the tolerance of each integrand, is bisected until every
+//! integrand meets its tolerance, max(epsabs, epsrel |result|). For a single
+//! integrand the result is the same as that of gsl_integration_qag. Unlike
+//! GSL, failure to reach the tolerance is not an error: the best estimate is
+//! returned.
+//!
+//! An object holds the workspace for one integration at a time; use one object
+//! per thread.
+class VectorQag {
+  protected:
+    size_t nvalues;
+    size_t limit;
+
+    // per subinterval: the limits, and the result and error per integrand
+    std::vector<double> alist, blist;
+    std::vector<double> rlist, elist;
+
+    // work arrays for the Gauss-Kronrod rule and the bisection
+    std::vector<double> fcenter, fv1, fv2;
+    std::vector<double> resabs, resasc, resasc1;
+    std::vector<double> area1, area2, error1, error2;
+
+    // running totals per integrand
+    std::vector<double> area, errsum, tolerance;
+    std::vector<int> roundoff_type1, roundoff_type2;
+
+    void qk15(VectorFunction f, void* params, size_t n, double a, double b, double* result,
+              double* abserr);
+    double relative_error(const double* error, size_t n, bool converged) const;
+
+  public:
+    VectorQag(size_t nvalues, size_t limit);
+
+    size_t get_nvalues() const { return nvalues; }
+
+    //! Integrates the first n integrands of f, n <= nvalues, from a to b, and
+    //! stores the integrals in result
+    void integrate(VectorFunction f, void* params, size_t n, double a, double b, double epsabs,
+                   double epsrel, double* result);
+};
+
+}    // namespace kariba
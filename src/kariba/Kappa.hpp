@@ -15,6 +15,8 @@ class Kappa : public Particles {
   public:
     Kappa(size_t size);
 
+    void reset() override;
+
     void set_p(double ucom, double bfield, double betaeff, double r, double fsc);
     void set_p(double max);
     void set_ndens();
@@ -32,6 +32,8 @@ class Mixed : public Particles {
   public:
     Mixed(size_t size);
 
+    void reset() override;
+
     void set_p(double ucom, double bfield, double betaeff, double r, double fsc);
     void set_p(double gmax);
     void set_ndens();
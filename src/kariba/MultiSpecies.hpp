@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "Particles.hpp"
+
+namespace kariba {
+
+//! Container that merges several populations of the same particle mass (e.g.
+//! primary electrons, pp and p-gamma secondaries and gamma-gamma pairs) onto
+//! a common logarithmic grid in Lorentz factor. The summed gdens and
+//! gdens_diff arrays can then be passed to Cyclosyn and Compton, so the
+//! radiation of all species in a zone is calculated in a single pass.
+//!
+//! Each species is interpolated onto the common grid, and contributes nothing
+//! outside its own range of Lorentz factors. The momentum space density and
+//! the differential are updated after every species that is added.
+class MultiSpecies : public Particles {
+  protected:
+    size_t nspecies;
+
+  public:
+    MultiSpecies(size_t size);
+
+    void reset() override;
+
+    void set_gamma(double gmin, double gmax);
+    void add_species(const Particles& species);
+    void merge(const std::vector<const Particles*>& species);
+
+    size_t get_nspecies() const { return nspecies; }
+};
+
+}    // namespace kariba
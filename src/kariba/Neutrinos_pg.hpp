@@ -1,10 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
 
+#include "PhotonField.hpp"
+#include "Products.hpp"
 #include "Radiation.hpp"
 
 namespace kariba {
@@ -18,31 +21,70 @@ struct HetaParams {
     double gp_max;
     gsl_spline* spline_Jp;
     gsl_interp_accel* acc_Jp;
-    std::string product;
+    Product product;
     gsl_interp_accel* acc_ng;
     gsl_spline* spline_ng;
     double nu_min;
     double nu_max;
+    double s;    // spectrum parameters from the KA08 tables at this η
+    double delta;
+    double Beta;
 };
 
 class Neutrinos_pg : public Radiation {
   public:
     Neutrinos_pg(size_t size, double Emin, double Emax);
 
+    //! The energy bins are computed in parallel when compiled with OpenMP.
+    //! acc_Jp is not used: every thread has its own accelerators for the
+    //! proton and target photon splines.
     void set_neutrinos(double gp_min, double gp_max, gsl_interp_accel* acc_Jp,
                        gsl_spline* spline_Jp, const std::vector<double>& en_perseg,
                        const std::vector<double>& lum_perseg, size_t nphot,
                        const std::string& outputConfiguration, const std::string& flavor,
                        int infosw, std::string_view source);
+    //! The same on the target photon field of the region, set up by the caller
+    void set_neutrinos(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                       const PhotonField& field, const std::string& outputConfiguration,
+                       const std::string& flavor, int infosw, std::string_view source);
+
+    //! Sets the spectra of several products, one per flavor, in one pass: the
+    //! proton and target photon densities in the integrand of eq. 70 from KA08
+    //! are evaluated once for all products that share an η grid, and the
+    //! integrals of all products are refined on common subintervals (see
+    //! VectorQag). All products must have the same energy grid and geometry.
+    static void set_products(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                             const std::vector<double>& en_perseg,
+                             const std::vector<double>& lum_perseg, size_t nphot,
+                             const std::string& outputConfiguration,
+                             const std::vector<std::string>& flavors,
+                             const std::vector<Neutrinos_pg*>& products, int infosw,
+                             std::string_view source);
+    static void set_products(double gp_min, double gp_max, gsl_spline* spline_Jp,
+                             const PhotonField& field, const std::string& outputConfiguration,
+                             const std::vector<std::string>& flavors,
+                             const std::vector<Neutrinos_pg*>& products, int infosw,
+                             std::string_view source);
 };
 
+//! Integrand of eq. 70 from KA08 for a given product. The non-template version
+//! dispatches on the product in the parameters.
+template <Product P>
+double Heta(double x, void* p);
 double Heta(double x, void* p);
 double colliding_protons(gsl_spline* spline_Jp, gsl_interp_accel* acc_Jp, double gp_min,
                          double gp_max, double Ep);
 double photons_jet(double eta, double Ep, gsl_spline* spline_ng, gsl_interp_accel* acc_ng,
                    double nu_min, double nu_max);
+void tables_photomeson(double& s, double& delta, double& Beta, Product product, double xeta);
 void tables_photomeson(double& s, double& delta, double& Beta, std::string_view product,
                        double xeta);
+//! The spectrum of a given product, with the parameters s, δ and B already
+//! looked up for η
+template <Product P>
+double PhiFunc(double eta, double eta0, double x, double s, double delta, double Beta);
+double PhiFunc(double eta, double eta0, double x, Product product, double s, double delta,
+               double Beta);
 double PhiFunc(double eta, double eta0, double x, std::string_view product);
 
 }    // namespace kariba
@@ -5,6 +5,8 @@
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
 
+#include "PPTables.hpp"
+#include "Products.hpp"
 #include "Radiation.hpp"
 
 namespace kariba {
@@ -13,10 +15,18 @@ class Neutrinos_pp : public Radiation {
   public:
     Neutrinos_pp(size_t size, double Emin, double Emax);
 
+    //! The energy bins are computed in parallel when compiled with OpenMP;
+    //! acc_Jp is not used.
     void set_neutrinos_pp(double p, double gammap_min, double gammap_max, double ntot_prot,
                           double nwind, double plfrac, gsl_interp_accel* acc_Jp,
                           gsl_spline* spline_Jp, const std::string& outputConfiguration,
                           const std::string& flavor, int infosw, std::string_view source);
+    //! The same, with σ_pp Jp from a table that can be shared with the other
+    //! pp products of the same protons
+    void set_neutrinos_pp(double p, double ntot_prot, double nwind, double plfrac,
+                          const PPCollisionRate& rate, const std::string& outputConfiguration,
+                          const std::string& flavor, int infosw, std::string_view source,
+                          const HadronicConstants& hadronic = hadronic_constants());
 };
 
 double multiplicity(double pspec);    // in Electrons.cpp
@@ -27,8 +37,17 @@ double sigma_pp(double Ep);              // in Gamma_rays.cpp
 double proton_dist(double gpmin, double Ep, double Epcode_max, gsl_spline* spline_Jp,
                    gsl_interp_accel* acc_Jp);    // in Gamma_rays.cpp
 
+//! Neutrino spectra from pion decay (Kelner et al. 2006), for muon and
+//! electron neutrinos; other products give zero
+double distr_pp(double lEv, double lEpi, Product flavor);
 double distr_pp(double lEv, double lEpi, std::string_view flavor);
+double secondary_spectrum(double Ep, double y, Product flavor);
 double secondary_spectrum(double Ep, double y, std::string_view flavor);
+//! The same, tabulated (secondary_spectrum on the y grid of
+//! Neutrinos_pp::set_neutrinos_pp) and set up on first use. Returns nullptr
+//! for products other than muon and electron neutrinos.
+const PPDistributionTable* distr_pp_table(Product flavor);
+const PPKernelTable* secondary_spectrum_table(Product flavor);
 
 double prob_fve();
 
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <gsl/gsl_spline.h>
+
+namespace kariba {
+
+//! The grids of the pp tables: the proton energy from 0.1 TeV, the lowest
+//! energy in the pp spectra, with 50 nodes per decade, and the ratio of the
+//! product and pion energies with 400 nodes per decade
+namespace pp_tables {
+const double lEp_min = -1.;
+const double lEp_max = 8.;
+const size_t nEp = 451;
+const double lx_min = -12.;
+const double lx_max = 0.;
+const size_t nx = 4801;
+}    // namespace pp_tables
+
+//! Bilinear table of a pp secondary spectrum F(Ep, y), y = log10(E/Ep), over
+//! log10(Ep) in TeV and y (Kelner et al. 2006); evaluated directly outside it
+class PPKernelTable {
+  protected:
+    double (*kernel)(double, double);
+    double lEp_min, dlEp;
+    size_t nEp;
+    double y_min, dy;
+    size_t ny;
+    std::vector<double> values;    //!< values[iEp * ny + iy]
+
+  public:
+    PPKernelTable(double (*kernel)(double Ep, double y), double lEp_min, double lEp_max,
+                  size_t nEp, double y_min, double dy, size_t ny);
+
+    //! The kernel at Ep = 10^lEp
+    double eval(double lEp, double y) const;
+};
+
+//! Linear table in log10(E/Epi) of a pion decay product distribution (Kelner
+//! et al. 2006); a step for x <= step_x is added after the interpolation
+class PPDistributionTable {
+  protected:
+    double (*distribution)(double, double);
+    double lx_min, dlx;
+    size_t nx;
+    double lstep_x, step_height;
+    std::vector<double> values;
+
+  public:
+    PPDistributionTable(double (*distribution)(double lE, double lEpi), double lx_min,
+                        double lx_max, size_t nx, double step_x = 0., double step_height = 0.);
+
+    double eval(double lE, double lEpi) const;
+};
+
+//! Linear table in log10(Ep) of σ_pp(Ep) Jp(Ep) in mb #/cm3/TeV, shared by all
+//! pp products of one proton distribution
+class PPCollisionRate {
+  protected:
+    double gammap_min, Epcode_max;
+    gsl_spline* spline_Jp;
+    double lEp_min, dlEp;
+    size_t nEp;
+    std::vector<double> values;
+
+  public:
+    //! Epcode_max: the maximum proton energy in TeV
+    PPCollisionRate(double gammap_min, double Epcode_max, gsl_spline* spline_Jp);
+
+    double get_gammap_min() const { return gammap_min; }
+    double get_Epcode_max() const { return Epcode_max; }
+
+    //! The product at Ep, in TeV, with lEp = log10(Ep)
+    double eval(double Ep, double lEp) const;
+};
+
+//! The constants of the pp products (Kelner et al. 2006) that only depend on
+//! the particle masses or on the slope of the protons: the normalisations of
+//! the electron and electron neutrino distributions of muon decay, computed
+//! once, and the pion multiplicities ñ, piecewise constant in the slope.
+struct HadronicConstants {
+    double prob;        //!< see prob(), for electrons and muon neutrinos
+    double prob_fve;    //!< see prob_fve(), for electron neutrinos
+
+    //! ñ for the γ-rays and for the electrons and neutrinos, for protons of
+    //! slope p
+    static constexpr double ntilde_grays(double p) {
+        return p <= 2.25 ? 1.10 : (p >= 2.75 ? 0.86 : 0.91);
+    }
+    static constexpr double ntilde_leptons(double p) {
+        return p <= 2.25 ? .77 : (p >= 2.75 ? .67 : .62);
+    }
+};
+
+//! The hadronic constants, computed on first use
+const HadronicConstants& hadronic_constants();
+
+}    // namespace kariba
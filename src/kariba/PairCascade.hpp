@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <gsl/gsl_spline.h>
+
+#include "Compton.hpp"
+#include "Cyclosyn.hpp"
+#include "GammaGamma.hpp"
+#include "PhotonField.hpp"
+#include "Powerlaw.hpp"
+
+namespace kariba {
+
+//! Pair cascade in one emitting region. The photons annihilate into pairs,
+//! which cool to a steady state (Powerlaw::Qggeefunction) and radiate
+//! cyclosynchrotron and inverse Compton photons, which annihilate in turn.
+//! Each generation recomputes the pairs from the photons of the previous one,
+//! and the photons from the primary ones plus the emission of the pairs,
+//! reduced by γγ absorption, until the spectrum changes by less than the
+//! tolerance.
+//!
+//! All spectra are comoving, in erg/s/Hz, on one log-spaced photon grid that
+//! is used for the emission of the pairs as well. The γγ rates, the Compton
+//! escape tables and all buffers are set up once, and reused by every
+//! generation and every call of run.
+class PairCascade {
+  protected:
+    std::vector<double> energy;     //!< photon energies in erg
+    std::vector<double> primary;    //!< photons injected from outside the cascade
+    std::vector<double> nphot;      //!< photons escaping the region
+    std::vector<double> tau;        //!< γγ opacity of the photons
+    PhotonField field;              //!< the escaping photons as target of the pairs
+
+    GammaGamma gg;
+    Powerlaw pairs;
+    Cyclosyn syn;
+    Compton ic;
+
+    gsl_spline* spline_gdens;    //!< interpolation of the pairs for the emission
+    gsl_interp_accel* acc_gdens;
+    gsl_spline* spline_diff;    //!< same for the derivative, for the absorption
+    gsl_interp_accel* acc_diff;
+
+    double r, bfield;
+    size_t max_generations;    //!< maximum number of generations
+    double tolerance;          //!< relative change of the spectrum for convergence
+    size_t generations;        //!< number of generations of the last run
+    bool converged;
+
+  public:
+    ~PairCascade();
+    //! size photons from numin to numax in Hz, and ngamma pair Lorentz
+    //! factors up to gmax
+    PairCascade(size_t size, double numin, double numax, size_t ngamma, double gmax);
+    PairCascade(const PairCascade&) = delete;
+    PairCascade& operator=(const PairCascade&) = delete;
+
+    const std::vector<double>& get_energy() const { return energy; }
+    const std::vector<double>& get_nphot() const { return nphot; }
+    const std::vector<double>& get_opacity() const { return tau; }
+    const Powerlaw& get_pairs() const { return pairs; }
+    size_t get_generations() const { return generations; }
+    bool get_converged() const { return converged; }
+
+    void set_geometry(const std::string& geom, double l1, double l2);
+    void set_beaming(double theta, double speed, double doppler);
+    void set_bfield(double b);
+    void set_generations(size_t n, double tol);
+
+    //! Adds a spectrum to the primary photons, interpolated in log-log on
+    //! the photon grid; en in erg and lum in erg/s/Hz
+    void add_primary(const std::vector<double>& en, const std::vector<double>& lum);
+    void clear_primary();
+
+    void run();
+};
+
+}    // namespace kariba
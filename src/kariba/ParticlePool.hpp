@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Bknpower.hpp"
+#include "Kappa.hpp"
+#include "Mixed.hpp"
+#include "Powerlaw.hpp"
+#include "Thermal.hpp"
+
+namespace kariba {
+
+//! Pool with one particle distribution of each type, all with the same array
+//! size. Multi-zone models (such as BHJet) set up a new distribution in every
+//! zone; taking it from the pool instead of constructing it means the arrays
+//! are allocated once per model evaluation rather than once per zone.
+//!
+//! The get_* methods return a reset distribution, which should be set up as if
+//! it were newly constructed. A reference is only valid until the next call to
+//! the same get_* method.
+class ParticlePool {
+  protected:
+    size_t size;
+
+    Thermal thermal;
+    Mixed mixed;
+    Kappa kappa;
+    Powerlaw powerlaw;
+    Bknpower bknpower;
+
+  public:
+    ParticlePool(size_t size);
+
+    size_t get_size() const { return size; }
+
+    Thermal& get_thermal();
+    Mixed& get_mixed();
+    Kappa& get_kappa();
+    Powerlaw& get_powerlaw();
+    Bknpower& get_bknpower();
+};
+
+}    // namespace kariba
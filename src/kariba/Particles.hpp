@@ -1,6 +1,9 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
+#include <memory>
+
+#include "Span.hpp"
 
 namespace kariba {
 
@@ -73,35 +76,60 @@ struct InjectionBknParams {
 //! Template class for particle distributions
 //! This class contains members and methods that are used for thermal,
 //! non-thermal and mixed distributions
+//!
+//! The five particle arrays are stored structure-of-arrays style in a single
+//! buffer, aligned to a cache line. Each array starts on a 64 byte boundary,
+//! and is padded with zeros up to a multiple of 64 bytes, so that loops over
+//! the arrays can use aligned vector loads without a scalar remainder. The
+//! arrays are exposed as views into this buffer.
 class Particles {
   protected:
+    //! Alignment (in bytes) of the buffer and of each array in it
+    static constexpr size_t alignment = 64;
+
+    //! Frees the buffer that was allocated with aligned new
+    struct AlignedDelete {
+        void operator()(double* ptr) const;
+    };
+
     double mass_gr;     //!< particle mass in grams
     double mass_kev;    //!< same as above but in keV, using electrons as "reference"
 
-    std::vector<double> p;        //!< array of particle momenta
-    std::vector<double> ndens;    //!< array of number density per unit volume, per unit momentum
-    std::vector<double> gamma;    //!< array of particle kinetic energies for each momentum
-    std::vector<double> gdens;    //!< array of number density per unit volume, per unit gamma
-    std::vector<double> gdens_diff;    //!< array with differential of number
-                                       //!< density for radiation calculation
+    size_t stride;    //!< distance between the start of consecutive arrays, in doubles
+    std::unique_ptr<double[], AlignedDelete> buffer;    //!< storage for all arrays below
+
+    Span<double> p;        //!< array of particle momenta
+    Span<double> ndens;    //!< array of number density per unit volume, per unit momentum
+    Span<double> gamma;    //!< array of particle kinetic energies for each momentum
+    Span<double> gdens;    //!< array of number density per unit volume, per unit gamma
+    Span<double> gdens_diff;    //!< array with differential of number
+                                //!< density for radiation calculation
+
+    void allocate(size_t size);
 
   public:
     Particles(size_t size);
+    Particles(const Particles& other);
+    Particles& operator=(const Particles& other);
+    virtual ~Particles() = default;
 
+    virtual void reset();
     void set_mass(double m);
     void initialize_gdens();
     void initialize_pdens();
     void gdens_differentiate();
 
-    const std::vector<double>& get_p() const { return p; }
+    double get_mass() const { return mass_gr; }
+
+    Span<const double> get_p() const { return p; }
 
-    const std::vector<double>& get_pdens() const { return ndens; }
+    Span<const double> get_pdens() const { return ndens; }
 
-    const std::vector<double>& get_gamma() const { return gamma; }
+    Span<const double> get_gamma() const { return gamma; }
 
-    const std::vector<double>& get_gdens() const { return gdens; }
+    Span<const double> get_gdens() const { return gdens; }
 
-    const std::vector<double>& get_gdens_diff() const { return gdens_diff; }
+    Span<const double> get_gdens_diff() const { return gdens_diff; }
 
     double count_particles();
     double count_particles_energy();
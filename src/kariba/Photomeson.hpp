@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include <gsl/gsl_spline.h>
+
+namespace kariba {
+
+//! The Kelner & Aharonian (2008) parameters s, δ and B over x_η = η/η_0; the
+//! splines take no accelerator, so the OpenMP pγ loops can share one table
+class PhotomesonTable {
+  protected:
+    gsl_spline* spline_s;
+    gsl_spline* spline_delta;
+    gsl_spline* spline_Beta;
+
+  public:
+    PhotomesonTable(const double* xeta, const double* s, const double* delta, const double* Beta,
+                    size_t size);
+    ~PhotomesonTable();
+
+    PhotomesonTable(const PhotomesonTable&) = delete;
+    PhotomesonTable& operator=(const PhotomesonTable&) = delete;
+
+    void eval(double xeta, double& s, double& delta, double& Beta) const;
+};
+
+}    // namespace kariba
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <gsl/gsl_spline.h>
+
+namespace kariba {
+
+//! Target photon number density of one zone, set up once and shared by the
+//! Compton, pγ and γγ modules
+class PhotonField {
+  protected:
+    std::vector<double> energy;         //!< photon energies in erg
+    std::vector<double> freq;           //!< photon frequencies in Hz
+    std::vector<double> density;        //!< number density in #/cm3/erg
+    std::vector<double> log_density;    //!< log10 of density, -100 where it is zero
+    double r, vol;                      //!< size and volume of the region of the field
+
+    gsl_spline* spline;    //!< interpolation of density over freq
+
+  public:
+    ~PhotonField();
+    //! A field of size photon energies; it is zero until set
+    explicit PhotonField(size_t size);
+    PhotonField(const PhotonField&) = delete;
+    PhotonField& operator=(const PhotonField&) = delete;
+
+    //! Sets the field from the luminosities lum in erg/s/Hz at the energies en
+    //! in erg (both of the size of the field) of a region of size r and volume
+    //! vol, as the photons produced in the region escape in r/c:
+    //! n = L r / (c h^2 ν vol)
+    void set_field(const std::vector<double>& en, const std::vector<double>& lum, double r,
+                   double vol);
+
+    size_t size() const { return energy.size(); }
+    double get_numin() const { return freq.front(); }
+    double get_numax() const { return freq.back(); }
+    double get_radius() const { return r; }
+    double get_volume() const { return vol; }
+    const std::vector<double>& get_energy() const { return energy; }
+    const std::vector<double>& get_frequency() const { return freq; }
+    const std::vector<double>& get_density() const { return density; }
+    const std::vector<double>& get_log_density() const { return log_density; }
+    gsl_spline* get_spline() const { return spline; }
+
+    //! The number density in #/cm3/erg at frequency nu in Hz, interpolated
+    //! with the accelerator acc of the calling thread; 1e-100 outside the field
+    double density_at(double nu, gsl_interp_accel* acc) const;
+};
+
+//! Target spectrum for sum_photons, interpolated as its log-log Akima spline
+class TargetSpectrum {
+  protected:
+    std::vector<double> lx;    //!< log10 of the target energies in units of mec2
+    std::vector<double> lL;    //!< log10 of the luminosities in erg/s/Hz, -100 where zero
+    std::vector<double> dL;    //!< slopes of the interpolation at the nodes
+    bool uniform;              //!< whether lx is uniform, with step dlx
+    double dlx;
+
+    gsl_spline* spline;    //!< the Akima interpolation, used to set the slopes
+
+    //! log10 of the luminosity at lx in interval k
+    double interpolate(size_t k, double logx) const;
+
+  public:
+    ~TargetSpectrum();
+    //! A spectrum of size target energies
+    explicit TargetSpectrum(size_t size);
+    TargetSpectrum(const TargetSpectrum&) = delete;
+    TargetSpectrum& operator=(const TargetSpectrum&) = delete;
+
+    //! Sets the spectrum from the luminosities lum in erg/s/Hz at the energies
+    //! en in erg, in increasing order
+    void set_spectrum(const std::vector<double>& en, const std::vector<double>& lum);
+
+    size_t size() const { return lx.size(); }
+    bool is_uniform() const { return uniform; }
+
+    //! Adds the spectrum to the luminosities lum of the first nphot photons of
+    //! energies en in erg, in increasing order; as in sum_photons, photons
+    //! below the first target energy or above the fifth last get nothing
+    void add(const std::vector<double>& en, std::vector<double>& lum, size_t nphot) const;
+    //! The same for nphot photons log-spaced from en_min to en_max in erg, as
+    //! those of Radiation objects; a single photon is at en_min
+    void add_log_grid(double en_min, double en_max, std::vector<double>& lum,
+                      size_t nphot) const;
+};
+
+}    // namespace kariba
@@ -4,7 +4,10 @@
 
 #include <gsl/gsl_spline.h>
 
+#include "GammaGamma.hpp"
+#include "PPTables.hpp"
 #include "Particles.hpp"
+#include "PhotonField.hpp"
 
 namespace kariba {
 
@@ -16,9 +19,16 @@ class Powerlaw : public Particles {
     double pmin, pmax;
     bool isEfficient;    //!< Proton acceleration
 
+    //! The pairs from γγ annihilation of photons of number densities Ngamma
+    //! in #/cm3/erg on the photon grid of gg
+    void pairs_from_photons(const GammaGamma& gg, double r, double bfield,
+                            const std::vector<double>& Ngamma, std::vector<double>& tau);
+
   public:
     Powerlaw(size_t size);
 
+    void reset() override;
+
     void set_p(double min, double ucom, double bfield, double betaeff, double r, double fsc);
     void set_p(double min, double gmax);
     void set_ndens();
@@ -47,10 +57,16 @@ class Powerlaw : public Particles {
     void set_gdens_pdens(double r, double beta, double Ljet, double ep, double pspec,
                          double& protdens);
 
-    // secondary electrons from pp
+    // secondary electrons from pp; the energy bins are computed in parallel
+    // when compiled with OpenMP, and acc_Jp is not used
     void set_pp_elecs(gsl_interp_accel* acc_Jp, gsl_spline* spline_Jp, double ntot_prot,
                       double nwind, double plfrac, double gammap_min, double gammap_max,
                       double bfield, double r);
+    // the same, with σ_pp Jp from a table that can be shared with the other pp
+    // products of the same protons
+    void set_pp_elecs(const PPCollisionRate& rate, double ntot_prot, double nwind,
+                      double plfrac, double bfield, double r,
+                      const HadronicConstants& hadronic = hadronic_constants());
     // convert secondary electrons from pg from Neutrinos units proper units for
     // synchrotron radiation
     void set_pg_electrons(const std::vector<double>& energy, const std::vector<double>& density,
@@ -60,6 +76,14 @@ class Powerlaw : public Particles {
     void Qggeefunction(double r, double vol, double bfield, size_t phot_number,
                        const std::vector<double>& en_perseg, const std::vector<double>& lum_perseg,
                        double gmax);
+    // the same with the γγ rates of gg, which also sets the γγ opacity tau of
+    // the photons
+    void Qggeefunction(const GammaGamma& gg, double r, double vol, double bfield,
+                       const std::vector<double>& lum_perseg, std::vector<double>& tau);
+    // the same in the target photon field of the region, on the photon grid
+    // of gg
+    void Qggeefunction(const GammaGamma& gg, double r, double bfield, const PhotonField& field,
+                       std::vector<double>& tau);
 
     void test();
 };
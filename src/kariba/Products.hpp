@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string_view>
+
+namespace kariba {
+
+//! The secondary products of hadronic (pp and pγ) interactions. The neutrino
+//! flavours are named after their lepton: muon/antimuon are the muon
+//! (anti)neutrinos, electron/antielectron the electron (anti)neutrinos.
+//!
+//! Strings are accepted at the public interfaces; they are converted once,
+//! after which the per-product kernels are selected outside the integration
+//! loops.
+enum class Product {
+    gamma_rays,
+    electrons,
+    positrons,
+    muon,
+    antimuon,
+    electron,
+    antielectron,
+    unknown
+};
+
+inline Product product_from_string(std::string_view name) {
+    if (name.compare("gamma_rays") == 0) {
+        return Product::gamma_rays;
+    } else if (name.compare("electrons") == 0) {
+        return Product::electrons;
+    } else if (name.compare("positrons") == 0) {
+        return Product::positrons;
+    } else if (name.compare("muon") == 0) {
+        return Product::muon;
+    } else if (name.compare("antimuon") == 0) {
+        return Product::antimuon;
+    } else if (name.compare("electron") == 0) {
+        return Product::electron;
+    } else if (name.compare("antielectron") == 0) {
+        return Product::antielectron;
+    }
+    return Product::unknown;
+}
+
+}    // namespace kariba
@@ -1,9 +1,42 @@
 #pragma once
 
+#include <vector>
+
+#include <gsl/gsl_spline2d.h>
+
 #include "Radiation.hpp"
 
 namespace kariba {
 
+//! The multicolour disk spectrum as a universal function of x = hν/kTin and
+//! of the ratio R = Rout/Rin of the disk radii,
+//!
+//!     K(x, R) = x^3 ∫_1^R ρ^2 / (exp(x ρ^(3/4)) - 1) dln ρ,
+//!
+//! so that the disk luminosity is 4π Rin^2 (kTin)^3 / (h^2 c^2) K(x, R). It is
+//! tabulated in log10(K e^x) over log10 x and log10 R, with K ∝ x^2 below the
+//! table and K ∝ x^2 exp(-x) above it.
+class DiskKernel {
+  protected:
+    std::vector<double> lx;         //!< log10 x
+    std::vector<double> lratio;     //!< log10 R
+    std::vector<double> lkernel;    //!< log10(K e^x), at [j * lx.size() + i]
+    gsl_spline2d* spline;
+
+  public:
+    DiskKernel();
+    ~DiskKernel();
+    DiskKernel(const DiskKernel&) = delete;
+    DiskKernel& operator=(const DiskKernel&) = delete;
+
+    //! Whether the table covers the ratio of the disk radii
+    bool contains(double ratio) const;
+    double eval(double x, double ratio, gsl_interp_accel* acc_x, gsl_interp_accel* acc_r) const;
+};
+
+//! The disk kernel, set up on first use
+const DiskKernel& disk_kernel();
+
 //! Class Shakura-Sunyeav disk, inherited from Radiation.hpp
 class ShSDisk : public Radiation {
   protected:
@@ -14,6 +47,9 @@ class ShSDisk : public Radiation {
                        //!< hbb varying with disk size. Also test with just one
                        //!< Comptonization zone, and with one up to hbb(Rin) and
                        //!< another up to the end of the nozzle
+    double covered;    //!< Fraction of the disk luminosity removed by cover_disk
+
+    double emitted(double en, gsl_interp_accel* acc_x, gsl_interp_accel* acc_r) const;
 
   public:
     ShSDisk(size_t size = 50);
@@ -27,6 +63,10 @@ class ShSDisk : public Radiation {
     double lum() const { return Ldisk; };
 
     void disk_spectrum();
+    //! Adds the observed spectrum, as set by disk_spectrum and cover_disk, to
+    //! the luminosities lum on the energies en in erg, within the energy range
+    //! of the disk, without going through the disk arrays
+    void add_spectrum(const std::vector<double>& en, std::vector<double>& lum) const;
     void cover_disk(double f);
     friend double disk_int(double nu, void* p);
 
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace kariba {
+
+//! Minimal non-owning view of a contiguous array, standing in for C++20's
+//! std::span. It offers the parts of the std::vector interface that are used
+//! on the particle arrays (indexing, size, data and iteration), so that code
+//! written for vectors keeps working on views into a shared buffer.
+template <typename T>
+class Span {
+  protected:
+    T* ptr;
+    size_t len;
+
+  public:
+    Span() : ptr(nullptr), len(0) {}
+    Span(T* data, size_t size) : ptr(data), len(size) {}
+
+    //! Allow a view of mutable data to be used as a read-only view
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(const Span<U>& other) : ptr(other.data()), len(other.size()) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    T& operator[](size_t i) const { return ptr[i]; }
+    T& front() const { return ptr[0]; }
+    T& back() const { return ptr[len - 1]; }
+
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + len; }
+
+    //! Copy the data into a new vector
+    std::vector<std::remove_const_t<T>> to_vector() const {
+        return std::vector<std::remove_const_t<T>>(ptr, ptr + len);
+    }
+};
+
+}    // namespace kariba
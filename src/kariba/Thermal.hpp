@@ -12,6 +12,8 @@ class Thermal : public Particles {
   public:
     Thermal(size_t size);
 
+    void reset() override;
+
     void set_p();
     void set_ndens();
     void set_temp_kev(double T);
@@ -19,6 +21,13 @@ class Thermal : public Particles {
 
     double K2(double x);
 
+    //! Analytic moments of a Maxwell-Juttner distribution with temperature T
+    //! (in kev), for particles of mass m (in grams). These do not require a
+    //! momentum grid, and can be used when only the average momentum (in g
+    //! cm/s) or the average Lorentz factor of a thermal population is needed.
+    static double av_p_mj(double T, double m);
+    static double av_gamma_mj(double T, double m);
+
     void test();
 };
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include <gsl/gsl_spline.h>
+
+#include <kariba/Powerlaw.hpp>
+#include <kariba/constants.hpp>
+
+//! The Lorentz factors of a power-law proton distribution, and the steffen
+//! spline of its density over them, to be freed by the caller
+inline gsl_spline* proton_spline(std::vector<double>& gamma) {
+    namespace karcst = kariba::constants;
+    kariba::Powerlaw protons(50);
+    protons.set_mass(karcst::pmgm);
+    protons.set_p(0.1 * karcst::pmgm * karcst::cee, 1e7);
+    protons.set_pspec(2.2);
+    protons.set_norm(1e3);
+    protons.set_ndens();
+    gamma = protons.get_gamma().to_vector();
+    kariba::Span<const double> gdens = protons.get_gdens();
+    gsl_spline* spline_Jp = gsl_spline_alloc(gsl_interp_steffen, gamma.size());
+    gsl_spline_init(spline_Jp, gamma.data(), gdens.data(), gamma.size());
+    return spline_Jp;
+}
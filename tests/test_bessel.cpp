@@ -0,0 +1,77 @@
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <gsl/gsl_sf_bessel.h>
+
+#include <kariba/Bessel.hpp>
+#include <kariba/Thermal.hpp>
+#include <kariba/constants.hpp>
+
+namespace karcst = kariba::constants;
+
+const double EPS = 1.0e-6;
+
+TEST_CASE("Fast Bessel functions") {
+    SUBCASE("Accuracy against GSL") {
+        // Cover both branches of the approximations, from very hot (x =
+        // 1/theta << 1) to cold (x >> 1) Maxwell-Juttner distributions
+        for (double lx = -3.; lx <= std::log10(600.); lx += 0.05) {
+            double x = std::pow(10., lx);
+            CAPTURE(x);
+            CHECK(kariba::bessel_k0(x) ==
+                  doctest::Approx(gsl_sf_bessel_Kn(0, x)).epsilon(EPS));
+            CHECK(kariba::bessel_k1(x) ==
+                  doctest::Approx(gsl_sf_bessel_Kn(1, x)).epsilon(EPS));
+            CHECK(kariba::bessel_k2(x) ==
+                  doctest::Approx(gsl_sf_bessel_Kn(2, x)).epsilon(EPS));
+        }
+    }
+
+    SUBCASE("Branch boundary is continuous") {
+        double below = std::nextafter(2., 0.);
+        CHECK(kariba::bessel_k2(below) == doctest::Approx(kariba::bessel_k2(2.)).epsilon(1e-7));
+    }
+
+    SUBCASE("Thermal normalization") {
+        // A thermal distribution normalized to n should integrate back to n
+        for (double T : {10., 100., 511., 5000.}) {
+            CAPTURE(T);
+            kariba::Thermal th(100);
+            th.set_temp_kev(T);
+            th.set_p();
+            th.set_norm(1.);
+            th.set_ndens();
+            CHECK(th.count_particles() == doctest::Approx(1.).epsilon(1e-2));
+        }
+    }
+}
+
+// Timing comparison with GSL; skipped by default, run with `test_main
+// --no-skip -tc="*benchmark*"`
+TEST_CASE("Fast Bessel functions benchmark" * doctest::skip()) {
+    const size_t n = 100000;
+    std::vector<double> xs(n);
+    for (size_t i = 0; i < n; i++) {
+        xs[i] = std::pow(10., -1. + 3. * static_cast<double>(i) / static_cast<double>(n));
+    }
+
+    double sum_gsl = 0., sum_fast = 0.;
+    auto start = std::chrono::steady_clock::now();
+    for (double x : xs) {
+        sum_gsl += gsl_sf_bessel_Kn(2, x);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (double x : xs) {
+        sum_fast += kariba::bessel_k2(x);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double t_gsl = std::chrono::duration<double>(mid - start).count();
+    double t_fast = std::chrono::duration<double>(end - mid).count();
+    MESSAGE("gsl_sf_bessel_Kn(2, x): " << t_gsl << " s; bessel_k2(x): " << t_fast
+                                       << " s; speed-up: " << t_gsl / t_fast);
+    CHECK(sum_fast == doctest::Approx(sum_gsl).epsilon(EPS));
+}
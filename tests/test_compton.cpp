@@ -2,6 +2,7 @@
 #include "doctest.h"
 
 #include <cmath>
+#include <vector>
 #include <gsl/gsl_spline.h>
 #include <kariba/Compton.hpp>
 #include <kariba/Cyclosyn.hpp>
@@ -208,3 +209,120 @@ TEST_CASE("Integration tests - Complete workflows") {
         gsl_interp_accel_free(acc_eldis);
     }
 }
+
+TEST_CASE("Seed fields") {
+    size_t nel = 50, nfreq = 50;
+    double Rg = karcst::gconst * 10. * karcst::msun / karcst::cee_cee;
+    double Rin = 10. * Rg, Rout = 1e4 * Rg;
+
+    kariba::ShSDisk disk;
+    disk.set_mbh(10.);
+    disk.set_rin(Rin);
+    disk.set_rout(Rout);
+    disk.set_luminosity(1e-2);
+    disk.disk_spectrum();
+
+    kariba::Thermal electrons(nel);
+    electrons.set_temp_kev(90.);
+    electrons.set_p();
+    electrons.set_norm(1e10);
+    electrons.set_ndens();
+    gsl_interp_accel* acc_eldis = gsl_interp_accel_alloc();
+    gsl_spline* spline_eldis = gsl_spline_alloc(gsl_interp_steffen, nel);
+    gsl_spline_init(spline_eldis, electrons.get_gamma().data(), electrons.get_gdens().data(), nel);
+    double gmin = electrons.get_gamma()[0];
+    double gmax = electrons.get_gamma()[nel - 1];
+
+    // The disk and two black bodies, each added to the seed field with the
+    // spline set up every time, or all added first and the spline set up once
+    kariba::Compton each(nfreq, 50), once(nfreq, 50);
+    for (kariba::Compton* ic : {&each, &once}) {
+        ic->set_frequency(1e16, 1e20);
+        ic->set_beaming(0.0, 0.0, 1.0);
+        ic->set_geometry("sphere", 75. * Rg);
+        ic->set_niter(static_cast<size_t>(1));
+    }
+    each.shsdisk_seed(disk.get_energy(), disk.tin(), Rin, Rout, disk.hdisk(), 10. * Rg);
+    each.bb_seed_k(disk.get_energy(), 1e3, 1e5);
+    each.bb_seed_kev(disk.get_energy(), 1e2, 0.3);
+    once.add_shsdisk_seed(disk.get_energy(), disk.tin(), Rin, Rout, disk.hdisk(), 10. * Rg);
+    once.add_bb_seed_k(disk.get_energy(), 1e3, 1e5);
+    once.add_bb_seed_kev(disk.get_energy(), 1e2, 0.3);
+    once.init_seed();
+
+    each.compton_spectrum(gmin, gmax, spline_eldis, acc_eldis);
+    once.compton_spectrum(gmin, gmax, spline_eldis, acc_eldis);
+    for (size_t i = 0; i < nfreq; i++) {
+        CHECK(once.get_nphot()[i] == doctest::Approx(each.get_nphot()[i]).epsilon(1e-10));
+    }
+    CHECK(once.get_nphot()[nfreq / 2] > 0.);
+
+    gsl_spline_free(spline_eldis);
+    gsl_interp_accel_free(acc_eldis);
+}
+
+TEST_CASE("Black-body seed fields") {
+    size_t nseed = 1000;
+    double Urad = 1e3, T = 1e5, kT = karcst::kboltz * T;
+    double TkeV = 0.3, kTkeV = TkeV * karcst::kboltz_kev2erg;
+    std::vector<double> energy(nseed);
+    for (size_t i = 0; i < nseed; i++) {
+        double x = static_cast<double>(i) / static_cast<double>(nseed - 1);
+        energy[i] = 1e-3 * kT * std::pow(1e5, x);
+    }
+
+    SUBCASE("Planck photon density") {
+        kariba::Compton ic(50, nseed);
+        ic.add_bb_seed_k(energy, Urad, T);
+        const std::vector<double>& field = ic.get_seed_field();
+        REQUIRE(field.size() == nseed);
+
+        // n(E) ∝ E^2 / (exp(E/kT) - 1) below 100 kT, normalised as in the
+        // original code so that the energy density is Urad / π, as
+        // ∫ x^3 / (exp(x) - 1) dx = π^4 / 15 and σ = 2 π^5 k^4 / (15 h^3 c^2)
+        double norm = field[0] * (std::exp(energy[0] / kT) - 1.) / (energy[0] * energy[0]);
+        double udens = 0.;
+        for (size_t i = 0; i < nseed; i++) {
+            CAPTURE(i);
+            double e = energy[i];
+            double planck = norm * e * e / (std::exp(e / kT) - 1.);
+            CHECK(field[i] == doctest::Approx(planck).epsilon(1e-12));
+            if (i > 0) {
+                // trapezoid rule in log E for ∫ E n(E) dE
+                double f0 = field[i - 1] * energy[i - 1] * energy[i - 1];
+                udens += 0.5 * (f0 + field[i] * e * e) * std::log(e / energy[i - 1]);
+            }
+        }
+        CHECK(udens == doctest::Approx(Urad / karcst::pi).epsilon(1e-4));
+    }
+
+    SUBCASE("Sum as in log space") {
+        // The seed field as the black-body fields were added before, each
+        // through log10 of the sum with the previous ones
+        std::vector<double> urad(nseed, 0.);
+        for (size_t i = 0; i < nseed; i++) {
+            double e = energy[i];
+            double bb_k = e < 1e2 * kT ? (2. * Urad * std::pow(e / karcst::herg, 2.)) /
+                                             (karcst::herg * std::pow(karcst::cee, 2.) *
+                                              karcst::sbconst * std::pow(T, 4) *
+                                              (std::exp(e / kT) - 1.))
+                                       : 1.e-100;
+            double bb_kev = e < 1e2 * kTkeV ? (2. * 1e2 * std::pow(e / karcst::herg, 2.)) /
+                                                  (karcst::herg * std::pow(karcst::cee, 2.) *
+                                                   karcst::sbconst *
+                                                   std::pow(kTkeV / karcst::kboltz, 4) *
+                                                   (std::exp(e / kTkeV) - 1.))
+                                            : 1.e-100;
+            urad[i] = std::log10(bb_k);
+            urad[i] = std::log10(std::pow(10., urad[i]) + bb_kev);
+        }
+
+        kariba::Compton ic(50, nseed);
+        ic.add_bb_seed_k(energy, Urad, T);
+        ic.add_bb_seed_kev(energy, 1e2, TkeV);
+        for (size_t i = 0; i < nseed; i++) {
+            CAPTURE(i);
+            CHECK(ic.get_seed_field()[i] == doctest::Approx(std::pow(10., urad[i])).epsilon(1e-12));
+        }
+    }
+}
@@ -0,0 +1,119 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kariba/Diagnostics.hpp>
+#include <kariba/Powerlaw.hpp>
+#include <kariba/constants.hpp>
+
+namespace karcst = kariba::constants;
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Diagnostics") {
+    kariba::Diagnostics sink;
+    const std::string path = "test_diagnostics.dat";
+    std::remove(path.c_str());
+    std::remove((path + ".bin").c_str());
+
+    std::vector<std::vector<double>> rows = {{1.5, 2.25e-30, 123456789.},
+                                             {-0.001, 1e100, 7.}};
+
+    SUBCASE("Text format") {
+        kariba::Diagnostics::Table& table = sink.table(path, {15, 25, 25});
+        CHECK(&sink.table(path, {15, 25, 25}) == &table);
+        for (const std::vector<double>& row : rows) {
+            table.add_row({row[0], row[1], row[2]});
+        }
+        CHECK(sink.find(path)->get_nrows() == 2);
+        sink.flush();
+        CHECK(table.get_nrows() == 0);
+        // a second flush appends, as the files were opened before
+        table.add_row({rows[0][0], rows[0][1], rows[0][2]});
+        sink.flush();
+
+        std::ostringstream expected;
+        for (size_t i : {0, 1, 0}) {
+            expected << std::left << std::setw(15) << rows[i][0] << std::setw(25) << rows[i][1]
+                     << std::setw(25) << rows[i][2] << std::endl;
+        }
+        CHECK(read_file(path) == expected.str());
+    }
+
+    SUBCASE("Columns wider than the format buffer") {
+        sink.table(path, {100, 15}).add_row({rows[0][0], rows[0][1]});
+        sink.flush();
+
+        std::ostringstream expected;
+        expected << std::left << std::setw(100) << rows[0][0] << std::setw(15) << rows[0][1]
+                 << std::endl;
+        CHECK(read_file(path) == expected.str());
+    }
+
+    SUBCASE("Binary format") {
+        sink.set_format(kariba::Diagnostics::Format::binary);
+        kariba::Diagnostics::Table& table = sink.table(path, {15, 25, 25});
+        for (const std::vector<double>& row : rows) {
+            table.add_row({row[0], row[1], row[2]});
+        }
+        sink.flush();
+
+        std::string contents = read_file(path + ".bin");
+        REQUIRE(contents.size() == 2 * sizeof(uint64_t) + 6 * sizeof(double));
+        const char* data = contents.data();
+        uint64_t shape[2];
+        std::copy(data, data + sizeof(shape), reinterpret_cast<char*>(shape));
+        CHECK(shape[0] == 3);
+        CHECK(shape[1] == 2);
+        std::vector<double> values(6);
+        std::copy(data + sizeof(shape), data + contents.size(),
+                  reinterpret_cast<char*>(values.data()));
+        for (size_t i = 0; i < 2; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                CHECK(values[i * 3 + j] == rows[i][j]);
+            }
+        }
+    }
+
+    SUBCASE("Clear") {
+        sink.table(path, {13}).add_row({1.});
+        sink.clear();
+        sink.flush();
+        CHECK(sink.find(path)->get_nrows() == 0);
+        CHECK(!std::ifstream(path).good());
+        CHECK(sink.find("other.dat") == nullptr);
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + ".bin").c_str());
+}
+
+TEST_CASE("Proton timescales diagnostics") {
+    kariba::Powerlaw protons(40);
+    protons.set_mass(karcst::pmgm);
+    kariba::diagnostics().clear();
+    protons.set_energy(2., 0.1, 0.1, 1e3, 1e6, 1e8, 1e8, 2, 1e5, 0., 1e3, ".", "test");
+
+    const kariba::Diagnostics::Table* table =
+        kariba::diagnostics().find("./Output/Particles/timescales_test.dat");
+    REQUIRE(table != nullptr);
+    CHECK(table->get_ncolumns() == 7);
+    CHECK(table->get_nrows() == 40);
+    // z/r_g and the Lorentz factors of the protons
+    CHECK(table->get_values()[0] == doctest::Approx(100.));
+    CHECK(table->get_values()[1] == doctest::Approx(2.));
+    kariba::diagnostics().clear();
+}
@@ -2,9 +2,12 @@
 
 #include <array>
 #include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <numeric>
+#include <string>
 #include <vector>
 
 #include <kariba/EBL.hpp>
@@ -156,3 +159,133 @@ TEST_CASE("EBL correction") {
         ebl_atten_gil(energy, luminosity, 1.0);
     }
 }
+
+TEST_CASE("EBL table") {
+    const kariba::EBLTable& table = kariba::gilmore_table();
+    CHECK(&kariba::gilmore_table() == &table);
+
+    const std::vector<double>& redshift = table.get_redshift();
+    const std::vector<double>& energy = table.get_energy();
+    REQUIRE(table.get_tau().size() == redshift.size() * energy.size());
+
+    // The interpolation passes through the tabulated values
+    gsl_interp_accel* acc_z = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_E = gsl_interp_accel_alloc();
+    for (size_t i = 0; i < redshift.size(); i += 8) {
+        for (size_t j = 0; j < energy.size(); j += 10) {
+            CHECK(table.eval(redshift[i], energy[j], acc_z, acc_E) ==
+                  doctest::Approx(table.get_tau()[j * redshift.size() + i]));
+        }
+    }
+    gsl_interp_accel_free(acc_z);
+    gsl_interp_accel_free(acc_E);
+}
+
+TEST_CASE("EBL curve") {
+    size_t ne = 50;
+    std::vector<double> energy(ne, 0.0);
+    for (size_t i = 0; i < ne; i++) {
+        energy[i] = std::pow(10, -2.9 + 4.8 * static_cast<double>(i) / 50.0);
+    }
+
+    for (double z : {0.005, 0.3, 2.5, 9.5}) {
+        std::shared_ptr<const kariba::EBLCurve> curve = kariba::gilmore_curve(energy, z);
+        CHECK(kariba::gilmore_curve(energy, z) == curve);
+
+        // Applying the curve is the same as the correction of ebl_atten_gil
+        std::vector<double> expected(ne, 1e40);
+        std::vector<double> luminosity(ne, 1e40);
+        ebl_atten_gil(energy, expected, z);
+        curve->apply(luminosity);
+        for (size_t i = 0; i < ne; i++) {
+            CHECK(luminosity[i] == expected[i]);
+        }
+    }
+
+    // A different grid gives a different curve
+    std::vector<double> other(energy.begin(), energy.begin() + 10);
+    CHECK(kariba::gilmore_curve(other, 0.3) != kariba::gilmore_curve(energy, 0.3));
+    CHECK(kariba::gilmore_curve(other, 0.3)->get_attenuation().size() == 10);
+}
+
+TEST_CASE("EBL models") {
+    const std::string path = "test_ebl_table.ebl";
+    kariba::write_ebl_table(kariba::gilmore_table(), path);
+
+    std::shared_ptr<const kariba::EBLTable> table = kariba::read_ebl_table(path);
+    CHECK(table->get_redshift() == kariba::gilmore_table().get_redshift());
+    CHECK(table->get_energy() == kariba::gilmore_table().get_energy());
+    CHECK(table->get_tau() == kariba::gilmore_table().get_tau());
+
+    // A registered model is loaded once, on first use, and gives the same
+    // curves as the built-in one it was written from
+    kariba::register_ebl_model("gilmore-file", path);
+    std::shared_ptr<const kariba::EBLTable> model = kariba::ebl_model("gilmore-file");
+    CHECK(kariba::ebl_model("gilmore-file") == model);
+    CHECK(kariba::ebl_model("gilmore").get() == &kariba::gilmore_table());
+
+    std::vector<double> energy(20);
+    for (size_t i = 0; i < energy.size(); i++) {
+        energy[i] = std::pow(10, -2.9 + 0.24 * static_cast<double>(i));
+    }
+    std::shared_ptr<const kariba::EBLCurve> curve = kariba::ebl_curve("gilmore-file", energy, 0.5);
+    CHECK(curve != kariba::gilmore_curve(energy, 0.5));
+    CHECK(curve->get_attenuation() == kariba::gilmore_curve(energy, 0.5)->get_attenuation());
+
+    SUBCASE("Registering a name again") {
+        // The same name for a table with twice the optical depth, which is
+        // loaded anew and gives new curves, with the attenuation squared
+        const std::string other = "test_ebl_table_doubled.ebl";
+        std::vector<double> tau = kariba::gilmore_table().get_tau();
+        for (double& t : tau) {
+            t *= 2.;
+        }
+        kariba::EBLTable doubled(kariba::gilmore_table().get_redshift(),
+                                 kariba::gilmore_table().get_energy(), tau);
+        kariba::write_ebl_table(doubled, other);
+        kariba::register_ebl_model("gilmore-file", other);
+        CHECK(kariba::ebl_model("gilmore-file")->get_tau() == tau);
+
+        std::shared_ptr<const kariba::EBLCurve> again =
+            kariba::ebl_curve("gilmore-file", energy, 0.5);
+        CHECK(again != curve);
+        for (size_t i = 0; i < energy.size(); i++) {
+            CAPTURE(i);
+            double attenuation = curve->get_attenuation()[i];
+            CHECK(again->get_attenuation()[i] ==
+                  doctest::Approx(attenuation * attenuation).epsilon(1e-12));
+        }
+        CHECK(again->get_attenuation() != curve->get_attenuation());
+
+        std::remove(other.c_str());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Batched EBL attenuation") {
+    size_t ne = 50, nrows = 7;
+    std::vector<double> energy(ne, 0.0);
+    for (size_t i = 0; i < ne; i++) {
+        energy[i] = std::pow(10, -2.9 + 4.8 * static_cast<double>(i) / 50.0);
+    }
+    std::shared_ptr<const kariba::EBLCurve> curve = kariba::gilmore_curve(energy, 0.3);
+
+    // Rows with different normalisations, some below the threshold
+    std::vector<double> spectra(nrows * ne);
+    for (size_t i = 0; i < nrows; i++) {
+        for (size_t k = 0; k < ne; k++) {
+            spectra[i * ne + k] =
+                std::pow(10., 5. * static_cast<double>(i) + 0.1 * static_cast<double>(k));
+        }
+    }
+    std::vector<double> expected = spectra;
+    curve->apply(spectra, nrows);
+    for (size_t i = 0; i < nrows; i++) {
+        std::vector<double> row(expected.begin() + i * ne, expected.begin() + (i + 1) * ne);
+        curve->apply(row);
+        for (size_t k = 0; k < ne; k++) {
+            CHECK(spectra[i * ne + k] == row[k]);
+        }
+    }
+}
@@ -0,0 +1,176 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+#include <kariba/Electrons.hpp>
+#include <kariba/GammaGamma.hpp>
+#include <kariba/PairCascade.hpp>
+#include <kariba/Powerlaw.hpp>
+#include <kariba/constants.hpp>
+
+namespace karcst = kariba::constants;
+
+//! Log-spaced photon energies from 1e-3 to 1e4 mec2, and a power-law number
+//! density
+static void gg_photons(std::vector<double>& en, std::vector<double>& n) {
+    size_t nphot = 71;
+    en.resize(nphot);
+    n.resize(nphot);
+    for (size_t k = 0; k < nphot; k++) {
+        double x =
+            std::pow(10., -3. + 7. * static_cast<double>(k) / static_cast<double>(nphot - 1));
+        en[k] = x * karcst::emerg;
+        n[k] = 1e20 * std::pow(x, -2.5);
+    }
+}
+
+TEST_CASE("Photon-photon annihilation") {
+    std::vector<double> en, n;
+    gg_photons(en, n);
+    size_t nphot = en.size();
+    kariba::GammaGamma gg(1.002, 1e3, 40, en);
+    const std::vector<double>& gamma = gg.get_gamma();
+    double dx = std::log10(en[2] / en[1]);
+
+    SUBCASE("Pair injection") {
+        std::vector<double> Q;
+        gg.pair_injection(n, Q);
+        REQUIRE(Q.size() == gamma.size());
+        for (size_t i = 0; i < gamma.size(); i++) {
+            double x2g = 2. * gamma[i];
+            if (x2g > en[nphot - 1] / karcst::emerg) {
+                CHECK(Q[i] == 1e-200);
+                continue;
+            }
+            // eq. 57 of MK95, with n(2γ) of the power law
+            double sum = 0.;
+            for (size_t k = 0; k < nphot; k++) {
+                double x = en[k] / karcst::emerg;
+                sum += dx * n[k] * x * std::log(10.) * kariba::production_rate(gamma[i], x);
+            }
+            double expected = 4. * 1e20 * std::pow(x2g, -2.5) * sum * karcst::emerg;
+            CAPTURE(gamma[i]);
+            CHECK(Q[i] == doctest::Approx(expected).epsilon(1e-10));
+        }
+    }
+
+    SUBCASE("Opacity") {
+        double r = 1e15;
+        std::vector<double> tau, tau2;
+        gg.opacity(n, r, tau);
+        std::vector<double> n2(n);
+        for (double& v : n2) {
+            v *= 2.;
+        }
+        gg.opacity(n2, r, tau2);
+        for (size_t j = 0; j < nphot; j++) {
+            double xj = en[j] / karcst::emerg;
+            double sum = 0.;
+            for (size_t k = 0; k < nphot; k++) {
+                double x = en[k] / karcst::emerg;
+                sum += dx * n[k] * x * std::log(10.) * kariba::production_rate(xj / 2., x);
+            }
+            CAPTURE(xj);
+            CHECK(tau[j] == doctest::Approx(sum * karcst::emerg * r / karcst::cee).epsilon(1e-10));
+            CHECK(tau2[j] == doctest::Approx(2. * tau[j]).epsilon(1e-12));
+            // no target above the threshold
+            if (xj * en[nphot - 1] / karcst::emerg < 1.) {
+                CHECK(tau[j] < 1e-100);
+            }
+        }
+        // for n ∝ x^-2.5 the opacity rises as x^1.5, away from the ends of the
+        // grid
+        CHECK(tau[50] / tau[40] == doctest::Approx(std::pow(10., 1.5)).epsilon(2e-2));
+    }
+
+    SUBCASE("Pairs from a photon spectrum") {
+        std::vector<double> lum(nphot);
+        for (size_t k = 0; k < nphot; k++) {
+            lum[k] = 1e22 * std::pow(en[k] / karcst::emerg, -0.5);
+        }
+        double r = 1e15, vol = 1e45, bfield = 10.;
+        kariba::Powerlaw pairs(40), shared(40);
+        pairs.Qggeefunction(r, vol, bfield, nphot, en, lum, 1e3);
+        std::vector<double> tau;
+        shared.Qggeefunction(gg, r, vol, bfield, lum, tau);
+        CHECK(tau.size() == nphot);
+
+        kariba::Span<const double> gdens = pairs.get_gdens();
+        kariba::Span<const double> gdens_shared = shared.get_gdens();
+        bool nonzero = false;
+        for (size_t i = 0; i < gamma.size(); i++) {
+            CHECK(pairs.get_gamma()[i] == gamma[i]);
+            CHECK(std::isfinite(gdens[i]));
+            CHECK(gdens_shared[i] == gdens[i]);
+            nonzero = nonzero || gdens[i] > 1e-100;
+        }
+        CHECK(nonzero);
+    }
+}
+
+//! A cascade in a compact region with a power-law primary spectrum from the
+//! infrared to the γ-rays
+static void run_cascade(kariba::PairCascade& cascade, double lnorm, std::vector<double>& en,
+                        std::vector<double>& lum) {
+    size_t n = 80;
+    en.resize(n);
+    lum.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        double x = std::pow(10., -6. + 10. * static_cast<double>(k) / static_cast<double>(n - 1));
+        en[k] = x * karcst::emerg;
+        lum[k] = lnorm * std::pow(x, -0.5);
+    }
+    cascade.set_geometry("cylinder", 1e14, 1e14);
+    cascade.set_bfield(10.);
+    cascade.clear_primary();
+    cascade.add_primary(en, lum);
+    cascade.run();
+}
+
+TEST_CASE("Pair cascade") {
+    kariba::PairCascade cascade(100, 1e9, 1e25, 40, 1e4);
+    std::vector<double> en, lum;
+    const std::vector<double>& energy = cascade.get_energy();
+    const std::vector<double>& nphot = cascade.get_nphot();
+    const std::vector<double>& tau = cascade.get_opacity();
+
+    SUBCASE("Pairs reprocess the primary photons") {
+        run_cascade(cascade, 1e20, en, lum);
+        CHECK(cascade.get_converged());
+        CHECK(cascade.get_generations() > 1);
+        double npairs = 0.;
+        for (double n : cascade.get_pairs().get_gdens()) {
+            npairs += n;
+        }
+        CHECK(npairs > 0.);
+        // synchrotron photons of the pairs below the primary spectrum
+        CHECK(energy[0] < en[0]);
+        CHECK(nphot[0] > 0.);
+
+        // the tables and buffers are reused by the next run
+        std::vector<double> first(nphot);
+        size_t generations = cascade.get_generations();
+        run_cascade(cascade, 1e20, en, lum);
+        CHECK(cascade.get_generations() == generations);
+        for (size_t i = 0; i < nphot.size(); i++) {
+            CHECK(nphot[i] == first[i]);
+        }
+    }
+
+    SUBCASE("Absorption of the γ-rays") {
+        run_cascade(cascade, 1e22, en, lum);
+        CHECK(cascade.get_converged());
+        bool thick = false;
+        for (size_t i = 0; i < energy.size(); i++) {
+            if (tau[i] > 10. && energy[i] < en.back()) {
+                thick = true;
+                double x = energy[i] / karcst::emerg;
+                CAPTURE(x);
+                CHECK(nphot[i] < 1e22 * std::pow(x, -0.5) / 5.);
+            }
+        }
+        CHECK(thick);
+    }
+}
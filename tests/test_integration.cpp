@@ -0,0 +1,62 @@
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gsl/gsl_integration.h>
+
+#include <kariba/Integration.hpp>
+
+//! A narrow peak at x = 0.3 and a smooth oscillation
+static double peak(double x) { return 1. / ((x - 0.3) * (x - 0.3) + 1e-4); }
+static double wave(double x) { return std::cos(5. * x) + 2.; }
+
+static void peak_and_wave(double x, double* f, void* /*params*/) {
+    f[0] = peak(x);
+    f[1] = wave(x);
+}
+
+static double peak_gsl(double x, void* /*params*/) { return peak(x); }
+static double wave_gsl(double x, void* /*params*/) { return wave(x); }
+
+static double gsl_qag(double (*f)(double, void*), double a, double b, double epsabs,
+                      double epsrel) {
+    gsl_integration_workspace* w = gsl_integration_workspace_alloc(100);
+    gsl_function F;
+    F.function = f;
+    F.params = nullptr;
+    double result, error;
+    gsl_integration_qag(&F, a, b, epsabs, epsrel, 100, GSL_INTEG_GAUSS15, w, &result, &error);
+    gsl_integration_workspace_free(w);
+    return result;
+}
+
+TEST_CASE("Vector-valued adaptive integration") {
+    double a = -1., b = 2.;
+    kariba::VectorQag qag(2, 100);
+    CHECK(qag.get_nvalues() == 2);
+
+    SUBCASE("A single integrand as gsl_integration_qag") {
+        // From the loose tolerance of the photohadronic spectra, met on the
+        // first rule, to tolerances that take many bisections
+        for (double eps : {1e0, 1e-3, 1e-6, 1e-9}) {
+            CAPTURE(eps);
+            double result;
+            qag.integrate(&peak_and_wave, nullptr, 1, a, b, 0., eps, &result);
+            CHECK(result == doctest::Approx(gsl_qag(&peak_gsl, a, b, 0., eps)).epsilon(1e-12));
+        }
+    }
+
+    SUBCASE("Several integrands meet their tolerance") {
+        double exact_peak = 100. * (std::atan(100. * (b - 0.3)) - std::atan(100. * (a - 0.3)));
+        double exact_wave = (std::sin(5. * b) - std::sin(5. * a)) / 5. + 2. * (b - a);
+        for (double eps : {1e-3, 1e-6, 1e-9}) {
+            CAPTURE(eps);
+            double result[2];
+            qag.integrate(&peak_and_wave, nullptr, 2, a, b, 0., eps, result);
+            CHECK(result[0] == doctest::Approx(exact_peak).epsilon(eps));
+            CHECK(result[1] == doctest::Approx(exact_wave).epsilon(eps));
+            CHECK(result[1] == doctest::Approx(gsl_qag(&wave_gsl, a, b, 0., eps)).epsilon(eps));
+        }
+    }
+}
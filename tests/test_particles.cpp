@@ -1,9 +1,12 @@
 #include "doctest.h"
 
 #include <cmath>
+#include <cstdint>
 #include <kariba/Bknpower.hpp>
 #include <kariba/Kappa.hpp>
 #include <kariba/Mixed.hpp>
+#include <kariba/MultiSpecies.hpp>
+#include <kariba/ParticlePool.hpp>
 #include <kariba/Powerlaw.hpp>
 #include <kariba/Thermal.hpp>
 #include <kariba/constants.hpp>
@@ -23,7 +26,7 @@ TEST_CASE("Particles subclass functionality") {
             CHECK(!thermal.get_gamma().empty());
 
             // Check that gamma values are reasonable for thermal distribution
-            const std::vector<double>& gamma = thermal.get_gamma();
+            kariba::Span<const double> gamma = thermal.get_gamma();
             CHECK(gamma[0] >= 1.0);
             CHECK(gamma[99] > gamma[0]);
         }
@@ -62,6 +65,38 @@ TEST_CASE("Particles subclass functionality") {
             CHECK(avg_gamma < 10.0);    // Not too relativistic for 511 keV
         }
 
+        SUBCASE("Analytic Maxwell-Juttner moments") {
+            for (double temp_kev : {5.0, 100.0, 511.0, 5000.0}) {
+                CAPTURE(temp_kev);
+                kariba::Thermal grid(500);
+                grid.set_temp_kev(temp_kev);
+                grid.set_p();
+                grid.set_norm(1.0);
+                grid.set_ndens();
+
+                // The grid only covers 1/100 to 20 times the temperature, so
+                // the numerical moments differ slightly from the exact ones
+                CHECK(kariba::Thermal::av_p_mj(temp_kev, karcst::emgm) ==
+                      doctest::Approx(grid.av_p()).epsilon(1e-2));
+            }
+
+            // Non-relativistic and ultra-relativistic limits
+            double theta = 1e-3;
+            double temp_kev = theta * karcst::emgm * karcst::cee_cee / karcst::kboltz_kev2erg;
+            CHECK(kariba::Thermal::av_p_mj(temp_kev, karcst::emgm) ==
+                  doctest::Approx(std::sqrt(8. * theta / karcst::pi) * karcst::emgm * karcst::cee)
+                      .epsilon(1e-2));
+            CHECK(kariba::Thermal::av_gamma_mj(temp_kev, karcst::emgm) ==
+                  doctest::Approx(1. + 1.5 * theta).epsilon(1e-5));
+            double hot_kev = 1e3 * karcst::emgm * karcst::cee_cee / karcst::kboltz_kev2erg;
+            CHECK(kariba::Thermal::av_gamma_mj(hot_kev, karcst::emgm) ==
+                  doctest::Approx(3e3).epsilon(1e-3));
+
+            // Very cold distributions should not underflow
+            CHECK(std::isfinite(kariba::Thermal::av_p_mj(1e-3, karcst::emgm)));
+            CHECK(std::isfinite(kariba::Thermal::av_gamma_mj(1e-3, karcst::emgm)));
+        }
+
         SUBCASE("Gamma-momentum relationship") {
             double temp_kev = 511.0;
             thermal.set_temp_kev(temp_kev);
@@ -70,8 +105,8 @@ TEST_CASE("Particles subclass functionality") {
             thermal.set_ndens();
 
             // Test that gamma arrays are consistent
-            const std::vector<double>& gamma = thermal.get_gamma();
-            const std::vector<double>& p = thermal.get_p();
+            kariba::Span<const double> gamma = thermal.get_gamma();
+            kariba::Span<const double> p = thermal.get_p();
 
             // Check relativistic energy-momentum relation for first few points
             for (size_t i = 0; i < 5; i++) {
@@ -98,7 +133,7 @@ TEST_CASE("Particles subclass functionality") {
             CHECK(!powerlaw.get_p().empty());
             CHECK(!powerlaw.get_gamma().empty());
 
-            const std::vector<double>& gamma = powerlaw.get_gamma();
+            kariba::Span<const double> gamma = powerlaw.get_gamma();
             CHECK(gamma[0] >= 1.0);
             CHECK(gamma[99] <= gmax * 1.001);    // Allow small numerical error
 
@@ -232,8 +267,8 @@ TEST_CASE("Particle distribution consistency checks") {
         thermal.set_norm(1.0);
         thermal.set_ndens();
 
-        const std::vector<double>& p = thermal.get_p();
-        const std::vector<double>& gamma = thermal.get_gamma();
+        kariba::Span<const double> p = thermal.get_p();
+        kariba::Span<const double> gamma = thermal.get_gamma();
 
         // Check relativistic energy-momentum relation: E^2 = (pc)^2 + (mc^2)^2
         for (size_t i = 0; i < 10; i++) {
@@ -253,8 +288,8 @@ TEST_CASE("Particle distribution consistency checks") {
         powerlaw.set_norm(1.0);
         powerlaw.set_ndens();
 
-        const std::vector<double>& p = powerlaw.get_p();
-        const std::vector<double>& gamma = powerlaw.get_gamma();
+        kariba::Span<const double> p = powerlaw.get_p();
+        kariba::Span<const double> gamma = powerlaw.get_gamma();
 
         // Check arrays are monotonically increasing
         for (size_t i = 1; i < 50; i++) {
@@ -266,3 +301,181 @@ TEST_CASE("Particle distribution consistency checks") {
         CHECK(gamma[49] <= gmax * 1.001);
     }
 }
+
+TEST_CASE("Reusing particle distributions") {
+    SUBCASE("Reset reproduces a new object") {
+        kariba::Mixed reused(50);
+        reused.set_mass(karcst::pmgm);
+        reused.set_temp_kev(50.0);
+        reused.set_pspec(2.5);
+        reused.set_plfrac(0.3);
+        reused.set_p(1e3);
+        reused.set_norm(10.0);
+        reused.set_ndens();
+        const double* data = reused.get_gdens().data();
+
+        reused.reset();
+        reused.set_temp_kev(500.0);
+        reused.set_pspec(2.0);
+        reused.set_plfrac(0.1);
+        reused.set_p(1e4);
+        reused.set_norm(1.0);
+        reused.set_ndens();
+
+        kariba::Mixed fresh(50);
+        fresh.set_temp_kev(500.0);
+        fresh.set_pspec(2.0);
+        fresh.set_plfrac(0.1);
+        fresh.set_p(1e4);
+        fresh.set_norm(1.0);
+        fresh.set_ndens();
+
+        CHECK(reused.get_gdens().data() == data);
+        for (size_t i = 0; i < 50; i++) {
+            CHECK(reused.get_p()[i] == fresh.get_p()[i]);
+            CHECK(reused.get_gdens()[i] == fresh.get_gdens()[i]);
+            CHECK(reused.get_gdens_diff()[i] == fresh.get_gdens_diff()[i]);
+        }
+    }
+
+    SUBCASE("Reset through the base class") {
+        kariba::Powerlaw protons(20);
+        protons.set_mass(karcst::pmgm);
+        kariba::Particles& particles = protons;
+        particles.reset();
+        CHECK(protons.get_mass() == karcst::emgm);
+    }
+
+    SUBCASE("Pool returns the same storage") {
+        kariba::ParticlePool pool(40);
+        CHECK(pool.get_size() == 40);
+
+        kariba::Thermal& first = pool.get_thermal();
+        first.set_temp_kev(100.0);
+        first.set_p();
+        first.set_norm(1.0);
+        first.set_ndens();
+        CHECK(first.count_particles() > 0.0);
+
+        kariba::Thermal& second = pool.get_thermal();
+        CHECK(&first == &second);
+        CHECK(second.get_p().size() == 40);
+        for (double n : second.get_pdens()) {
+            CHECK(n == 0.0);
+        }
+
+        kariba::Powerlaw& pl = pool.get_powerlaw();
+        CHECK(pl.get_gamma().size() == 40);
+    }
+}
+
+TEST_CASE("Particle array storage") {
+    kariba::Powerlaw powerlaw(37);
+    double pmin = 1e-3 * karcst::emgm * karcst::cee;
+    powerlaw.set_p(pmin, 1e3);
+    powerlaw.set_pspec(2.0);
+    powerlaw.set_norm(1.0);
+    powerlaw.set_ndens();
+
+    SUBCASE("Arrays are aligned views") {
+        for (const double* data : {powerlaw.get_p().data(), powerlaw.get_pdens().data(),
+                                   powerlaw.get_gamma().data(), powerlaw.get_gdens().data(),
+                                   powerlaw.get_gdens_diff().data()}) {
+            CHECK(reinterpret_cast<std::uintptr_t>(data) % 64 == 0);
+        }
+        CHECK(powerlaw.get_p().size() == 37);
+        CHECK(powerlaw.get_gdens_diff().size() == 37);
+
+        // The accessors copy into vectors on request, for code that needs one
+        std::vector<double> gamma = powerlaw.get_gamma().to_vector();
+        CHECK(gamma.size() == 37);
+        CHECK(gamma[36] == powerlaw.get_gamma()[36]);
+    }
+
+    SUBCASE("Copies own their data") {
+        kariba::Powerlaw copy(powerlaw);
+        CHECK(copy.get_p().data() != powerlaw.get_p().data());
+        CHECK(copy.get_gdens()[10] == powerlaw.get_gdens()[10]);
+
+        copy.set_norm(2.0);
+        copy.set_ndens();
+        CHECK(copy.get_gdens()[10] == doctest::Approx(2.0 * powerlaw.get_gdens()[10]));
+    }
+}
+
+TEST_CASE("Merging particle species") {
+    double pmin = 10.0 * karcst::emgm * karcst::cee;
+
+    kariba::Powerlaw primary(100);
+    primary.set_p(pmin, 1e4);
+    primary.set_pspec(2.0);
+    primary.set_norm(1.0);
+    primary.set_ndens();
+
+    kariba::Powerlaw secondary(60);
+    secondary.set_p(1e2 * karcst::emgm * karcst::cee, 1e6);
+    secondary.set_pspec(2.5);
+    secondary.set_norm(1e-3);
+    secondary.set_ndens();
+
+    SUBCASE("Single species is reproduced") {
+        kariba::MultiSpecies leptons(100);
+        leptons.merge({&primary});
+
+        CHECK(leptons.get_nspecies() == 1);
+        CHECK(leptons.get_gamma()[0] == primary.get_gamma()[0]);
+        CHECK(leptons.get_gamma()[99] == primary.get_gamma()[99]);
+        CHECK(leptons.get_gdens()[0] == doctest::Approx(primary.get_gdens()[0]));
+        CHECK(leptons.get_gdens()[99] == doctest::Approx(primary.get_gdens()[99]));
+        CHECK(leptons.count_particles_energy() ==
+              doctest::Approx(primary.count_particles_energy()).epsilon(1e-3));
+    }
+
+    SUBCASE("Overlapping species are summed") {
+        kariba::MultiSpecies leptons(200);
+        leptons.merge({&primary, &secondary});
+
+        CHECK(leptons.get_nspecies() == 2);
+        CHECK(leptons.get_gamma()[0] == doctest::Approx(primary.get_gamma()[0]));
+        CHECK(leptons.get_gamma()[199] == doctest::Approx(secondary.get_gamma()[59]));
+        CHECK(leptons.count_particles_energy() ==
+              doctest::Approx(primary.count_particles_energy() +
+                              secondary.count_particles_energy())
+                  .epsilon(2e-2));
+
+        for (size_t i = 0; i < 200; i++) {
+            CHECK(leptons.get_gdens()[i] >= 0.0);
+            CHECK(std::isfinite(leptons.get_gdens_diff()[i]));
+        }
+
+        // Above the primary cut-off, only the secondaries contribute
+        kariba::MultiSpecies secondaries(200);
+        secondaries.set_gamma(leptons.get_gamma().front(), leptons.get_gamma().back());
+        secondaries.add_species(secondary);
+        size_t nabove = 0;
+        for (size_t i = 0; i < 200; i++) {
+            if (leptons.get_gamma()[i] > primary.get_gamma().back()) {
+                CAPTURE(i);
+                CHECK(leptons.get_gdens()[i] ==
+                      doctest::Approx(secondaries.get_gdens()[i]).epsilon(1e-12));
+                nabove++;
+            }
+        }
+        CHECK(nabove > 0);
+    }
+
+    SUBCASE("Species with a different mass are skipped") {
+        kariba::Powerlaw protons(50);
+        protons.set_mass(karcst::pmgm);
+        protons.set_p(1e-1 * karcst::pmgm * karcst::cee, 1e3);
+        protons.set_pspec(2.0);
+        protons.set_norm(1.0);
+        protons.set_ndens();
+
+        kariba::MultiSpecies leptons(100);
+        leptons.set_gamma(2.0, 1e4);
+        leptons.add_species(protons);
+        CHECK(leptons.get_nspecies() == 0);
+        CHECK(leptons.count_particles_energy() == 0.0);
+    }
+}
@@ -0,0 +1,300 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_spline.h>
+
+#include <kariba/GammaRays.hpp>
+#include <kariba/Neutrinos_pg.hpp>
+#include <kariba/Neutrinos_pp.hpp>
+#include <kariba/Powerlaw.hpp>
+#include <kariba/Products.hpp>
+#include <kariba/constants.hpp>
+
+#include "fixtures.hpp"
+
+namespace karcst = kariba::constants;
+
+const double EPS = 1e-12;
+
+TEST_CASE("Photomeson tables") {
+    double s, delta, Beta;
+
+    SUBCASE("Table nodes are reproduced") {
+        kariba::tables_photomeson_gamma(s, delta, Beta, 1.1);
+        CHECK(s == doctest::Approx(0.0768).epsilon(EPS));
+        CHECK(delta == doctest::Approx(0.544).epsilon(EPS));
+        CHECK(Beta == doctest::Approx(2.86e-19).epsilon(EPS));
+        kariba::tables_photomeson_gamma(s, delta, Beta, 10.);
+        CHECK(s == doctest::Approx(0.0761).epsilon(EPS));
+        CHECK(delta == doctest::Approx(2.43).epsilon(EPS));
+        CHECK(Beta == doctest::Approx(1.93e-16).epsilon(EPS));
+
+        kariba::tables_photomeson(s, delta, Beta, "muon", 2.);
+        CHECK(s == doctest::Approx(0.446).epsilon(EPS));
+        CHECK(delta == doctest::Approx(0.940).epsilon(EPS));
+        CHECK(Beta == doctest::Approx(2.11e-16).epsilon(EPS));
+        kariba::tables_photomeson(s, delta, Beta, "electrons", 3.);
+        CHECK(s == doctest::Approx(0.658).epsilon(EPS));
+        CHECK(delta == doctest::Approx(3.09).epsilon(EPS));
+        CHECK(Beta == doctest::Approx(6.43e-19).epsilon(EPS));
+        kariba::tables_photomeson(s, delta, Beta, "antielectron", 100.);
+        CHECK(s == doctest::Approx(0.077).epsilon(EPS));
+        CHECK(delta == doctest::Approx(2.40).epsilon(EPS));
+        CHECK(Beta == doctest::Approx(5.48e-15).epsilon(EPS));
+    }
+
+    SUBCASE("Repeated lookups are identical") {
+        double s2, delta2, Beta2;
+        kariba::tables_photomeson(s, delta, Beta, "antimuon", 7.3);
+        kariba::tables_photomeson(s2, delta2, Beta2, "antimuon", 7.3);
+        CHECK(s == s2);
+        CHECK(delta == delta2);
+        CHECK(Beta == Beta2);
+    }
+
+    SUBCASE("Unknown products") {
+        kariba::tables_photomeson(s, delta, Beta, "tau", 2.);
+        CHECK(s == 0.);
+        CHECK(delta == 0.);
+        CHECK(Beta == 0.);
+    }
+
+    SUBCASE("Precomputed spectrum parameters") {
+        double eta0 = 0.313;
+        double eta = 5.5 * eta0;
+        for (double x : {1e-3, 0.05, 0.2, 0.5}) {
+            kariba::tables_photomeson_gamma(s, delta, Beta, eta / eta0);
+            CHECK(kariba::PhiFunc_gamma(eta, eta0, x, s, delta, Beta) ==
+                  kariba::PhiFunc_gamma(eta, eta0, x));
+            kariba::tables_photomeson(s, delta, Beta, "positrons", eta / eta0);
+            CHECK(kariba::PhiFunc(eta, eta0, x, kariba::Product::positrons, s, delta, Beta) ==
+                  kariba::PhiFunc(eta, eta0, x, "positrons"));
+        }
+    }
+
+    SUBCASE("Product names") {
+        CHECK(kariba::product_from_string("gamma_rays") == kariba::Product::gamma_rays);
+        CHECK(kariba::product_from_string("positrons") == kariba::Product::positrons);
+        CHECK(kariba::product_from_string("antimuon") == kariba::Product::antimuon);
+        CHECK(kariba::product_from_string("antielectron") == kariba::Product::antielectron);
+        CHECK(kariba::product_from_string("tau") == kariba::Product::unknown);
+
+        // The string interface gives the same spectra as the enum one
+        for (double lEv : {-3., -2.5, -2.}) {
+            CHECK(kariba::distr_pp(lEv, 0., "muon") ==
+                  kariba::distr_pp(lEv, 0., kariba::Product::muon));
+            CHECK(kariba::secondary_spectrum(10., lEv / 3., "electron") ==
+                  kariba::secondary_spectrum(10., lEv / 3., kariba::Product::electron));
+        }
+        CHECK(kariba::distr_pp(-2., 0., "positrons") == 0.);
+    }
+}
+
+//! A power-law target photon field
+static void target_photons(std::vector<double>& en, std::vector<double>& lum) {
+    size_t nphot = 60;
+    en.resize(nphot);
+    lum.resize(nphot);
+    for (size_t i = 0; i < nphot; i++) {
+        double nu =
+            std::pow(10., 9. + 14. * static_cast<double>(i) / static_cast<double>(nphot - 1));
+        en[i] = nu * karcst::herg;
+        lum[i] = 1e32 * std::pow(nu / 1e14, -0.7);
+    }
+}
+
+//! Sets the pγ products with the given number of threads (if compiled with
+//! OpenMP), and returns the neutrino and γ-ray spectra one after the other
+static std::vector<double> photohadronic_spectra(int nthreads) {
+#ifdef _OPENMP
+    int nthreads_orig = omp_get_max_threads();
+    omp_set_num_threads(nthreads);
+#else
+    (void) nthreads;
+#endif
+    std::vector<double> gamma, en, lum;
+    gsl_spline* spline_Jp = proton_spline(gamma);
+    target_photons(en, lum);
+    size_t np = gamma.size(), nphot = en.size();
+    gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+
+    kariba::Neutrinos_pg neutrinos(20, 1e-6, 1e8);
+    neutrinos.set_geometry("cylinder", 1e15, 1e16);
+    neutrinos.set_beaming(0.1, 0.9, 2.);
+    neutrinos.set_neutrinos(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot, ".",
+                            "muon", 0, "JET");
+    kariba::Grays grays(20, 1e20, 1e30);
+    grays.set_geometry("cylinder", 1e15, 1e16);
+    grays.set_beaming(0.1, 0.9, 2.);
+    grays.set_grays_pg(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot);
+
+    gsl_spline_free(spline_Jp);
+    gsl_interp_accel_free(acc_Jp);
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads_orig);
+#endif
+
+    std::vector<double> result = neutrinos.get_nphot();
+    std::vector<double> nphot_grays = grays.get_nphot();
+    result.insert(result.end(), nphot_grays.begin(), nphot_grays.end());
+    return result;
+}
+
+//! The spectrum of one pγ product in erg/s/Hz at the energies en_phot in erg,
+//! integrated product by product with gsl_integration_qag over the integrand
+//! Heta, as set_neutrinos did before it integrated all products together
+static std::vector<double> scalar_spectrum(const std::vector<double>& en_phot, double gp_min,
+                                           double gp_max, gsl_spline* spline_Jp,
+                                           const std::vector<double>& en,
+                                           const std::vector<double>& lum, double r, double vol,
+                                           kariba::Product product) {
+    const size_t N = 10;
+    double mpc2 = karcst::pmgm * karcst::cee * karcst::cee;
+    double eta_zero = 0.313, eta_max = 99.99, eta_min = 1.10;
+    if (product == kariba::Product::electrons || product == kariba::Product::antielectron) {
+        eta_min = 3.001;
+    }
+    double Epion = (product == kariba::Product::gamma_rays ? 137.5e6 : 139.6e6) / karcst::erg;
+    double deta = std::log10(eta_max / eta_min) / (N - 1);
+
+    size_t nphot = en.size();
+    std::vector<double> freq(nphot), Uphot(nphot);
+    for (size_t k = 0; k < nphot; k++) {
+        freq[k] = en[k] / karcst::herg;
+        Uphot[k] = lum[k] * (r / karcst::cee / (karcst::herg * karcst::herg * freq[k] * vol));
+    }
+    gsl_spline* spline_ng = gsl_spline_alloc(gsl_interp_steffen, nphot);
+    gsl_spline_init(spline_ng, freq.data(), Uphot.data(), nphot);
+    gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_ng = gsl_interp_accel_alloc();
+    gsl_integration_workspace* w = gsl_integration_workspace_alloc(100);
+
+    std::vector<double> spectrum(en_phot.size());
+    for (size_t i = 0; i < en_phot.size(); i++) {
+        double Ev = en_phot[i];
+        double dNdEv = 1e-100;
+        if (Ev > Epion && Ev <= gp_max * mpc2) {
+            dNdEv = 0.;
+            for (size_t j = 0; j < N; j++) {
+                double eta = eta_zero * std::pow(10., std::log10(eta_min) +
+                                                          static_cast<double>(j) * deta);
+                kariba::HetaParams params{eta,     eta_zero,  Ev,      gp_min,  gp_max,
+                                          spline_Jp, acc_Jp,  product, acc_ng,  spline_ng,
+                                          freq[0], freq[nphot - 1], 0., 0., 0.};
+                kariba::tables_photomeson(params.s, params.delta, params.Beta, product,
+                                          eta / eta_zero);
+                gsl_function F;
+                F.function = &kariba::Heta;
+                F.params = &params;
+                double result, error;
+                gsl_integration_qag(&F, std::log10(Ev / (gp_max * mpc2)),
+                                    std::log10(Ev / (gp_min * mpc2)), 1e0, 1e0, 100, 1, w,
+                                    &result, &error);
+                dNdEv += mpc2 * mpc2 / 4. * result * deta * eta * std::log(10.);
+            }
+        }
+        spectrum[i] = dNdEv * karcst::herg * Ev * vol;
+    }
+
+    gsl_integration_workspace_free(w);
+    gsl_interp_accel_free(acc_ng);
+    gsl_interp_accel_free(acc_Jp);
+    gsl_spline_free(spline_ng);
+    return spectrum;
+}
+
+TEST_CASE("Photohadronic production") {
+    SUBCASE("Results do not depend on the number of threads") {
+        std::vector<double> serial = photohadronic_spectra(1);
+        std::vector<double> parallel = photohadronic_spectra(4);
+        REQUIRE(serial.size() == parallel.size());
+        bool nonzero = false;
+        for (size_t i = 0; i < serial.size(); i++) {
+            CHECK(serial[i] == parallel[i]);
+            nonzero = nonzero || serial[i] > 1e-90;
+        }
+        CHECK(nonzero);
+    }
+
+    SUBCASE("Single products as integrated one by one") {
+        std::vector<double> gamma, en, lum;
+        gsl_spline* spline_Jp = proton_spline(gamma);
+        target_photons(en, lum);
+        size_t np = gamma.size(), nphot = en.size();
+        gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+
+        for (const char* flavor : {"muon", "electron", "antielectron", "gamma_rays"}) {
+            CAPTURE(flavor);
+            kariba::Neutrinos_pg neutrinos(20, 1e-6, 1e10);
+            neutrinos.set_geometry("cylinder", 1e15, 1e16);
+            neutrinos.set_beaming(0.1, 0.9, 2.);
+            neutrinos.set_neutrinos(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot,
+                                    ".", flavor, 0, "JET");
+            std::vector<double> expected =
+                scalar_spectrum(neutrinos.get_energy(), gamma[0], gamma[np - 1], spline_Jp, en,
+                                lum, 1e15, neutrinos.get_volume(),
+                                kariba::product_from_string(flavor));
+            bool nonzero = false;
+            for (size_t i = 0; i < expected.size(); i++) {
+                CAPTURE(i);
+                CHECK(neutrinos.get_nphot()[i] == doctest::Approx(expected[i]).epsilon(EPS));
+                nonzero = nonzero || expected[i] > 1e-90;
+            }
+            CHECK(nonzero);
+        }
+
+        gsl_spline_free(spline_Jp);
+        gsl_interp_accel_free(acc_Jp);
+    }
+
+    SUBCASE("All products in one pass") {
+        std::vector<double> gamma, en, lum;
+        gsl_spline* spline_Jp = proton_spline(gamma);
+        target_photons(en, lum);
+        size_t np = gamma.size(), nphot = en.size();
+        gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+
+        std::vector<std::string> flavors = {"gamma_rays", "electrons", "positrons", "muon",
+                                            "antimuon",   "electron",  "antielectron"};
+        std::vector<kariba::Neutrinos_pg> together, separate;
+        for (size_t k = 0; k < flavors.size(); k++) {
+            together.emplace_back(30, 1e-6, 1e10);
+            separate.emplace_back(30, 1e-6, 1e10);
+        }
+        std::vector<kariba::Neutrinos_pg*> products;
+        for (size_t k = 0; k < flavors.size(); k++) {
+            together[k].set_geometry("cylinder", 1e15, 1e16);
+            together[k].set_beaming(0.1, 0.9, 2.);
+            products.push_back(&together[k]);
+            separate[k].set_geometry("cylinder", 1e15, 1e16);
+            separate[k].set_beaming(0.1, 0.9, 2.);
+            separate[k].set_neutrinos(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot,
+                                      ".", flavors[k], 0, "JET");
+        }
+        kariba::Neutrinos_pg::set_products(gamma[0], gamma[np - 1], spline_Jp, en, lum, nphot,
+                                           ".", flavors, products, 0, "JET");
+        gsl_spline_free(spline_Jp);
+        gsl_interp_accel_free(acc_Jp);
+
+        // The integrals of each product are refined on common subintervals,
+        // which differ from those of a single product; with the loose
+        // integration tolerance the spectra agree to a few percent
+        for (size_t k = 0; k < flavors.size(); k++) {
+            CAPTURE(flavors[k]);
+            const std::vector<double>& nphot_together = together[k].get_nphot();
+            const std::vector<double>& nphot_separate = separate[k].get_nphot();
+            for (size_t i = 0; i < nphot_separate.size(); i++) {
+                CHECK(nphot_together[i] == doctest::Approx(nphot_separate[i]).epsilon(3e-2));
+            }
+        }
+    }
+}
@@ -0,0 +1,231 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <gsl/gsl_spline.h>
+
+#include <kariba/Compton.hpp>
+#include <kariba/GammaGamma.hpp>
+#include <kariba/GammaRays.hpp>
+#include <kariba/Neutrinos_pg.hpp>
+#include <kariba/PhotonField.hpp>
+#include <kariba/Powerlaw.hpp>
+#include <kariba/constants.hpp>
+
+#include "fixtures.hpp"
+
+namespace karcst = kariba::constants;
+
+//! Log-spaced photon energies from 1e9 to 1e23 Hz, with a power-law
+//! luminosity
+static void field_photons(std::vector<double>& en, std::vector<double>& lum) {
+    size_t nphot = 60;
+    en.resize(nphot);
+    lum.resize(nphot);
+    for (size_t i = 0; i < nphot; i++) {
+        double nu =
+            std::pow(10., 9. + 14. * static_cast<double>(i) / static_cast<double>(nphot - 1));
+        en[i] = nu * karcst::herg;
+        lum[i] = 1e32 * std::pow(nu / 1e14, -0.7);
+    }
+}
+
+TEST_CASE("Photon field") {
+    std::vector<double> en, lum;
+    field_photons(en, lum);
+    size_t nphot = en.size();
+    double r = 1e15, vol = 1e46;
+    kariba::PhotonField field(nphot);
+    gsl_interp_accel* acc = gsl_interp_accel_alloc();
+
+    SUBCASE("Unset field") {
+        CHECK(field.size() == nphot);
+        CHECK(field.density_at(1e14, acc) == 1e-100);
+    }
+
+    SUBCASE("Densities") {
+        field.set_field(en, lum, r, vol);
+        CHECK(field.get_numin() == doctest::Approx(1e9));
+        CHECK(field.get_numax() == doctest::Approx(1e23));
+        for (size_t i = 0; i < nphot; i++) {
+            double nu = en[i] / karcst::herg;
+            double n = lum[i] * r / (karcst::cee * karcst::herg * en[i] * vol);
+            CHECK(field.get_density()[i] == doctest::Approx(n).epsilon(1e-12));
+            CHECK(field.get_log_density()[i] == doctest::Approx(std::log10(n)).epsilon(1e-12));
+            CHECK(field.density_at(nu, acc) == doctest::Approx(n).epsilon(1e-12));
+        }
+        CHECK(field.density_at(0.5 * field.get_numin(), acc) == 1e-100);
+        CHECK(field.density_at(2. * field.get_numax(), acc) == 1e-100);
+    }
+
+    gsl_interp_accel_free(acc);
+}
+
+TEST_CASE("Photon field shared by the modules") {
+    std::vector<double> en, lum;
+    field_photons(en, lum);
+    size_t nphot = en.size();
+
+    SUBCASE("Photohadronic products") {
+        std::vector<double> gamma;
+        gsl_spline* spline_Jp = proton_spline(gamma);
+        size_t np = gamma.size();
+        gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+
+        kariba::Neutrinos_pg neutrinos(20, 1e-6, 1e8), shared_neutrinos(20, 1e-6, 1e8);
+        kariba::Grays grays(20, 1e20, 1e30), shared_grays(20, 1e20, 1e30);
+        for (kariba::Radiation* rad : std::vector<kariba::Radiation*>{
+                 &neutrinos, &shared_neutrinos, &grays, &shared_grays}) {
+            rad->set_geometry("cylinder", 1e15, 1e16);
+            rad->set_beaming(0.1, 0.9, 2.);
+        }
+        kariba::PhotonField field(nphot);
+        field.set_field(en, lum, 1e15, neutrinos.get_volume());
+
+        neutrinos.set_neutrinos(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot, ".",
+                                "muon", 0, "JET");
+        shared_neutrinos.set_neutrinos(gamma[0], gamma[np - 1], spline_Jp, field, ".", "muon", 0,
+                                       "JET");
+        grays.set_grays_pg(gamma[0], gamma[np - 1], acc_Jp, spline_Jp, en, lum, nphot);
+        shared_grays.set_grays_pg(gamma[0], gamma[np - 1], spline_Jp, field);
+
+        bool nonzero = false;
+        for (size_t i = 0; i < neutrinos.get_nphot().size(); i++) {
+            CHECK(shared_neutrinos.get_nphot()[i] == neutrinos.get_nphot()[i]);
+            CHECK(shared_grays.get_nphot()[i] == grays.get_nphot()[i]);
+            nonzero = nonzero || neutrinos.get_nphot()[i] > 1e-90;
+        }
+        CHECK(nonzero);
+
+        gsl_spline_free(spline_Jp);
+        gsl_interp_accel_free(acc_Jp);
+    }
+
+    SUBCASE("Pairs from γγ annihilation") {
+        double r = 1e15, vol = 1e45, bfield = 10.;
+        std::vector<double> lum_gg(nphot);
+        for (size_t k = 0; k < nphot; k++) {
+            lum_gg[k] = 1e40 * lum[k];
+        }
+        kariba::GammaGamma gg(1.002, 1e3, 40, en);
+        kariba::PhotonField field(nphot);
+        field.set_field(en, lum_gg, r, vol);
+        kariba::Powerlaw pairs(40), shared(40);
+        std::vector<double> tau, tau_shared;
+        pairs.Qggeefunction(gg, r, vol, bfield, lum_gg, tau);
+        shared.Qggeefunction(gg, r, bfield, field, tau_shared);
+        for (size_t k = 0; k < nphot; k++) {
+            CHECK(tau_shared[k] == doctest::Approx(tau[k]).epsilon(1e-12));
+        }
+        for (size_t i = 0; i < 40; i++) {
+            CHECK(shared.get_gdens()[i] == doctest::Approx(pairs.get_gdens()[i]).epsilon(1e-12));
+        }
+    }
+
+    SUBCASE("Compton seed photons") {
+        // The field of a cylinder, as seed photons counted through the
+        // cross-section of the region: n = L / (c h E π r^2)
+        double r = 1e15, z = 1e16;
+        kariba::Compton ic(20, nphot), cyclosyn(20, nphot);
+        ic.set_geometry("cylinder", r, z);
+        cyclosyn.set_geometry("cylinder", r, z);
+        kariba::PhotonField field(nphot);
+        field.set_field(en, lum, r, ic.get_volume());
+        CHECK(field.get_radius() == r);
+        CHECK(field.get_volume() == ic.get_volume());
+
+        ic.add_field_seed(field);
+        cyclosyn.add_cyclosyn_seed(en, lum);
+        for (size_t i = 0; i < nphot; i++) {
+            double n = lum[i] / (karcst::cee * karcst::herg * en[i] * karcst::pi * r * r);
+            CHECK(ic.get_seed_energy()[i] == en[i]);
+            CHECK(ic.get_seed_field()[i] == doctest::Approx(n).epsilon(1e-12));
+            CHECK(ic.get_seed_field()[i] ==
+                  doctest::Approx(cyclosyn.get_seed_field()[i]).epsilon(1e-12));
+        }
+    }
+}
+
+//! The log-log Akima interpolation of the target added to the photons, as
+//! sum_photons did it with a spline
+static std::vector<double> target_reference(const std::vector<double>& en,
+                                            const std::vector<double>& targ_en,
+                                            const std::vector<double>& targ_lum) {
+    size_t ntarg = targ_en.size();
+    std::vector<double> lx(ntarg), lL(ntarg), lum(en.size(), 0.);
+    for (size_t k = 0; k < ntarg; k++) {
+        lx[k] = std::log10(targ_en[k] / karcst::emerg);
+        lL[k] = std::log10(targ_lum[k]);
+    }
+    gsl_interp_accel* acc = gsl_interp_accel_alloc();
+    gsl_spline* spline = gsl_spline_alloc(gsl_interp_akima, ntarg);
+    gsl_spline_init(spline, lx.data(), lL.data(), ntarg);
+    for (size_t i = 0; i < en.size(); i++) {
+        double logx = std::log10(en[i] / karcst::emerg);
+        if (logx >= lx[0] && logx <= lx[ntarg - 5]) {
+            lum[i] = std::pow(10., gsl_spline_eval(spline, logx, acc));
+        }
+    }
+    gsl_spline_free(spline);
+    gsl_interp_accel_free(acc);
+    return lum;
+}
+
+TEST_CASE("Target spectrum") {
+    // a curved target spectrum, on a grid uniform in log and on one that is not
+    size_t ntarg = 40;
+    std::vector<double> targ_en(ntarg), targ_lum(ntarg), targ_en2(ntarg), targ_lum2(ntarg);
+    for (size_t k = 0; k < ntarg; k++) {
+        double t = static_cast<double>(k) / static_cast<double>(ntarg - 1);
+        for (auto [en, lum, x] : {std::tuple(&targ_en, &targ_lum, t),
+                                  std::tuple(&targ_en2, &targ_lum2, t * t)}) {
+            double nu = std::pow(10., 12. + 6. * x);
+            (*en)[k] = nu * karcst::herg;
+            (*lum)[k] = 1e30 * std::pow(nu / 1e15, 1. / 3.) * std::exp(-nu / 1e16);
+        }
+    }
+    std::vector<double> en, lum;
+    field_photons(en, lum);
+    size_t nphot = en.size();
+
+    kariba::TargetSpectrum target(ntarg), target2(ntarg);
+    target.set_spectrum(targ_en, targ_lum);
+    target2.set_spectrum(targ_en2, targ_lum2);
+    CHECK(target.is_uniform());
+    CHECK(!target2.is_uniform());
+
+    for (const auto& [spectrum, tx, tl] : {std::tuple(&target, &targ_en, &targ_lum),
+                                           std::tuple(&target2, &targ_en2, &targ_lum2)}) {
+        std::vector<double> expected = target_reference(en, *tx, *tl);
+        std::vector<double> added(nphot, 1.), on_grid(nphot, 1.), summed(nphot, 1.);
+        spectrum->add(en, added, nphot);
+        spectrum->add_log_grid(en[0], en[nphot - 1], on_grid, nphot);
+        kariba::sum_photons(nphot, en, summed, ntarg, *tx, *tl);
+        bool nonzero = false;
+        for (size_t i = 0; i < nphot; i++) {
+            CAPTURE(i);
+            CHECK(added[i] - 1. == doctest::Approx(expected[i]).epsilon(1e-10));
+            CHECK(on_grid[i] == doctest::Approx(added[i]).epsilon(1e-10));
+            CHECK(summed[i] == added[i]);
+            nonzero = nonzero || expected[i] > 0.;
+        }
+        CHECK(nonzero);
+    }
+
+    SUBCASE("Grids of fewer than two photons") {
+        // A photon inside the target, with nothing added to those after it
+        size_t i = nphot / 2;
+        std::vector<double> single(3, 1.), added(1, 1.), none(3, 1.);
+        target.add_log_grid(en[i], en[nphot - 1], single, 1);
+        target.add({en[i]}, added, 1);
+        target.add_log_grid(en[i], en[nphot - 1], none, 0);
+        CHECK(added[0] > 1.);
+        CHECK(single[0] == doctest::Approx(added[0]).epsilon(1e-10));
+        CHECK(single[1] == 1.);
+        CHECK(single[2] == 1.);
+        CHECK(none == std::vector<double>(3, 1.));
+    }
+}
@@ -0,0 +1,174 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <gsl/gsl_spline.h>
+
+#include <kariba/Electrons.hpp>
+#include <kariba/GammaRays.hpp>
+#include <kariba/Neutrinos_pp.hpp>
+#include <kariba/PPTables.hpp>
+#include <kariba/Powerlaw.hpp>
+#include <kariba/Products.hpp>
+#include <kariba/constants.hpp>
+
+#include "fixtures.hpp"
+
+namespace karcst = kariba::constants;
+
+TEST_CASE("pp kernel tables") {
+    const double dy = 3. / 59.;
+
+    SUBCASE("Secondary spectra") {
+        // Between and on the nodes, and above the tabulated proton energies
+        for (double lEp : {-0.5, 0.013, 1.7, 3.2345, 5., 7.99, 9.5}) {
+            for (int i : {0, 10, 31, 50, 57}) {
+                double y = -3. + i * dy;
+                double Ep = std::pow(10., lEp);
+                CAPTURE(lEp);
+                CAPTURE(y);
+                CHECK(kariba::gspec_pp_table().eval(lEp, y) ==
+                      doctest::Approx(kariba::gspec_pp(Ep, y)).epsilon(1e-3));
+                CHECK(kariba::elec_spec_pp_table().eval(lEp, y) ==
+                      doctest::Approx(kariba::elec_spec_pp(Ep, y)).epsilon(1e-3));
+                for (kariba::Product flavor : {kariba::Product::muon, kariba::Product::electron}) {
+                    CHECK(kariba::secondary_spectrum_table(flavor)->eval(lEp, y) ==
+                          doctest::Approx(kariba::secondary_spectrum(Ep, y, flavor))
+                              .epsilon(1e-3));
+                }
+            }
+        }
+    }
+
+    SUBCASE("Pion decay distributions") {
+        // Including both sides of the step in the muon neutrino distribution,
+        // at x = 0.427, and below the tabulated range
+        for (double lx : {-14., -8.3, -2., -0.7, -0.37, -0.36, -0.1}) {
+            CAPTURE(lx);
+            CHECK(kariba::elec_dist_pp_table().eval(lx - 1., -1.) ==
+                  doctest::Approx(kariba::elec_dist_pp(lx - 1., -1.)).epsilon(1e-3));
+            for (kariba::Product flavor : {kariba::Product::muon, kariba::Product::electron}) {
+                CHECK(kariba::distr_pp_table(flavor)->eval(lx - 1., -1.) ==
+                      doctest::Approx(kariba::distr_pp(lx - 1., -1., flavor)).epsilon(1e-3));
+            }
+        }
+    }
+
+    SUBCASE("Unknown products") {
+        CHECK(kariba::distr_pp_table(kariba::Product::positrons) == nullptr);
+        CHECK(kariba::secondary_spectrum_table(kariba::Product::gamma_rays) == nullptr);
+    }
+}
+
+//! Sets the pp products of a power-law proton distribution with the given
+//! number of threads (if compiled with OpenMP), either from the proton spline
+//! or from a shared table of σ_pp Jp, and returns the spectra one after the other
+static std::vector<double> pp_spectra(int nthreads, bool shared) {
+#ifdef _OPENMP
+    int nthreads_orig = omp_get_max_threads();
+    omp_set_num_threads(nthreads);
+#else
+    (void) nthreads;
+#endif
+    double pspec = 2.2;
+    std::vector<double> gamma;
+    gsl_spline* spline_Jp = proton_spline(gamma);
+    gsl_interp_accel* acc_Jp = gsl_interp_accel_alloc();
+    size_t np = gamma.size();
+    double gpmin = gamma[0], gpmax = gamma[np - 1];
+    double Ep_max = gpmax * karcst::pmgm * karcst::cee * karcst::cee;    // in erg
+    kariba::PPCollisionRate rate(gpmin, Ep_max * karcst::erg * 1.e-12, spline_Jp);
+
+    kariba::Grays grays(30, 1e20, 1e30);
+    kariba::Neutrinos_pp neutrinos(30, 1e-6, 1e8);
+    kariba::Powerlaw electrons(30);
+    electrons.set_pspec(pspec);
+    if (shared) {
+        grays.set_grays_pp(pspec, 1e3, 1e2, 0.1, rate);
+        neutrinos.set_neutrinos_pp(pspec, 1e3, 1e2, 0.1, rate, ".", "muon", 0, "JET");
+        electrons.set_pp_elecs(rate, 1e3, 1e2, 0.1, 10., 1e15);
+    } else {
+        grays.set_grays_pp(pspec, gpmin, gpmax, 1e3, 1e2, 0.1, acc_Jp, spline_Jp);
+        neutrinos.set_neutrinos_pp(pspec, gpmin, gpmax, 1e3, 1e2, 0.1, acc_Jp, spline_Jp, ".",
+                                   "muon", 0, "JET");
+        electrons.set_pp_elecs(acc_Jp, spline_Jp, 1e3, 1e2, 0.1, gpmin, Ep_max, 10., 1e15);
+    }
+
+    gsl_spline_free(spline_Jp);
+    gsl_interp_accel_free(acc_Jp);
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads_orig);
+#endif
+
+    std::vector<double> result = grays.get_nphot();
+    const std::vector<double>& nphot_neutrinos = neutrinos.get_nphot();
+    result.insert(result.end(), nphot_neutrinos.begin(), nphot_neutrinos.end());
+    kariba::Span<const double> gdens_electrons = electrons.get_gdens();
+    result.insert(result.end(), gdens_electrons.begin(), gdens_electrons.end());
+    return result;
+}
+
+TEST_CASE("pp production") {
+    SUBCASE("Collision rate table") {
+        std::vector<double> gamma;
+        gsl_spline* spline_Jp = proton_spline(gamma);
+        size_t np = gamma.size();
+        double Epcode_max = gamma[np - 1] * karcst::mprotTeV;
+        kariba::PPCollisionRate rate(gamma[0], Epcode_max, spline_Jp);
+
+        // Below the threshold, in the table and above the protons
+        for (double Ep : {1.1e-3, 1.3e-3, 0.0271, 1., 523., 0.99 * Epcode_max, 2. * Epcode_max}) {
+            CAPTURE(Ep);
+            double expected = kariba::sigma_pp(Ep) *
+                              kariba::proton_dist(gamma[0], Ep, Epcode_max, spline_Jp, nullptr);
+            CHECK(rate.eval(Ep, std::log10(Ep)) == doctest::Approx(expected).epsilon(1e-3));
+        }
+        gsl_spline_free(spline_Jp);
+    }
+
+    SUBCASE("A shared table gives the same spectra") {
+        std::vector<double> own = pp_spectra(1, false);
+        std::vector<double> shared = pp_spectra(1, true);
+        REQUIRE(own.size() == shared.size());
+        for (size_t i = 0; i < own.size(); i++) {
+            CHECK(own[i] == doctest::Approx(shared[i]).epsilon(1e-12));
+        }
+    }
+
+    SUBCASE("Results do not depend on the number of threads") {
+        std::vector<double> serial = pp_spectra(1, true);
+        std::vector<double> parallel = pp_spectra(4, true);
+        REQUIRE(serial.size() == parallel.size());
+        bool nonzero = false;
+        for (size_t i = 0; i < serial.size(); i++) {
+            CHECK(serial[i] == parallel[i]);
+            nonzero = nonzero || serial[i] > 1e-40;
+        }
+        CHECK(nonzero);
+    }
+}
+
+TEST_CASE("Hadronic constants") {
+    const kariba::HadronicConstants& hadronic = kariba::hadronic_constants();
+    CHECK(&hadronic == &kariba::hadronic_constants());
+    CHECK(hadronic.prob == kariba::prob());
+    CHECK(hadronic.prob_fve == kariba::prob_fve());
+    CHECK(hadronic.prob > 0.);
+    CHECK(hadronic.prob_fve > 0.);
+
+    static_assert(kariba::HadronicConstants::ntilde_grays(2.) == 1.10);
+    static_assert(kariba::HadronicConstants::ntilde_leptons(3.) == .67);
+    for (double p : {1.5, 2.25, 2.5, 2.75, 3.2}) {
+        CAPTURE(p);
+        CHECK(kariba::set_ntilde(p) == kariba::HadronicConstants::ntilde_grays(p));
+        CHECK(kariba::multiplicity(p) == kariba::HadronicConstants::ntilde_leptons(p));
+    }
+    CHECK(kariba::multiplicity(2.5) == .62);
+    CHECK(kariba::set_ntilde(2.5) == 0.91);
+}
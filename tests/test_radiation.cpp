@@ -1,10 +1,12 @@
 #include "doctest.h"
 
 #include <cmath>
+#include <gsl/gsl_integration.h>
 #include <gsl/gsl_spline.h>
 #include <kariba/BBody.hpp>
 #include <kariba/Compton.hpp>
 #include <kariba/Cyclosyn.hpp>
+#include <kariba/ExternalField.hpp>
 #include <kariba/Powerlaw.hpp>
 #include <kariba/ShSDisk.hpp>
 #include <kariba/Thermal.hpp>
@@ -119,6 +121,207 @@ TEST_CASE("Radiation base class functionality") {
     }
 }
 
+TEST_CASE("External spectra on a given grid") {
+    SUBCASE("ShSDisk") {
+        double rg = karcst::gconst * 10. * karcst::msun / karcst::cee_cee;
+        kariba::ShSDisk disk(30);
+        disk.set_mbh(10.);
+        disk.set_rin(10. * rg);
+        disk.set_rout(1e4 * rg);
+        disk.set_luminosity(1e-2);
+        disk.set_inclination(0.3);
+        disk.disk_spectrum();
+        disk.cover_disk(0.2);
+
+        // Interior points of the disk grid, and points outside of it
+        const std::vector<double>& energy = disk.get_energy_obs();
+        std::vector<double> en(energy.begin() + 1, energy.end() - 1);
+        en.push_back(0.5 * energy.front());
+        en.push_back(2. * energy.back());
+        std::vector<double> lum(en.size(), 1.);
+        disk.add_spectrum(en, lum);
+        for (size_t i = 0; i + 2 < en.size(); i++) {
+            CHECK(lum[i] == doctest::Approx(1. + disk.get_nphot_obs()[i + 1]));
+        }
+        CHECK(lum[en.size() - 2] == 1.);
+        CHECK(lum[en.size() - 1] == 1.);
+    }
+
+    SUBCASE("BBody") {
+        kariba::BBody bbody(25);
+        bbody.set_temp_k(1e4);
+        bbody.set_lum(1e38);
+        bbody.bb_spectrum();
+
+        const std::vector<double>& energy = bbody.get_energy_obs();
+        std::vector<double> en(energy.begin() + 1, energy.end() - 1);
+        en.push_back(0.5 * energy.front());
+        std::vector<double> lum(en.size(), 0.);
+        bbody.add_spectrum(en, lum);
+        for (size_t i = 0; i + 1 < en.size(); i++) {
+            CHECK(lum[i] == doctest::Approx(bbody.get_nphot_obs()[i + 1]));
+        }
+        CHECK(lum.back() == 0.);
+    }
+}
+
+static double kernel_integrand(double lrho, void* pars) {
+    double x = *static_cast<double*>(pars);
+    double rho = std::exp(lrho);
+    return rho * rho / std::expm1(x * std::pow(rho, 0.75));
+}
+
+TEST_CASE("Disk kernel") {
+    const kariba::DiskKernel& kernel = kariba::disk_kernel();
+    gsl_interp_accel* acc_x = gsl_interp_accel_alloc();
+    gsl_interp_accel* acc_r = gsl_interp_accel_alloc();
+
+    CHECK(kernel.contains(100.));
+    CHECK(!kernel.contains(1.));
+    CHECK(!kernel.contains(1e9));
+
+    SUBCASE("Integral") {
+        gsl_integration_workspace* w = gsl_integration_workspace_alloc(1000);
+        for (double ratio : {3., 100., 2e5}) {
+            for (double x : {1e-4, 0.01, 0.5, 3., 30., 200.}) {
+                gsl_function F;
+                F.function = &kernel_integrand;
+                F.params = &x;
+                double result, error;
+                gsl_integration_qag(&F, 0., std::log(ratio), 0., 1e-10, 1000, GSL_INTEG_GAUSS61,
+                                    w, &result, &error);
+                CHECK(kernel.eval(x, ratio, acc_x, acc_r) ==
+                      doctest::Approx(x * x * x * result).epsilon(2e-3));
+            }
+        }
+        gsl_integration_workspace_free(w);
+    }
+
+    SUBCASE("Asymptotes") {
+        // Rayleigh-Jeans everywhere: x^2 (R^(5/4) - 1) / (5/4)
+        double ratio = 1e3;
+        double x = 1e-11;
+        CHECK(kernel.eval(x, ratio, acc_x, acc_r) ==
+              doctest::Approx(x * x * (std::pow(ratio, 1.25) - 1.) / 1.25).epsilon(1e-3));
+        // Wien from the inner edge: 4/3 x^2 exp(-x)
+        x = 1e3;
+        CHECK(kernel.eval(x, ratio, acc_x, acc_r) ==
+              doctest::Approx(4. / 3. * x * x * std::exp(-x)).epsilon(1e-2));
+    }
+
+    gsl_interp_accel_free(acc_x);
+    gsl_interp_accel_free(acc_r);
+}
+
+//! The comoving energy density of a BLR or torus of radius R and energy
+//! density U, and its share of the cooling, as Ghisellini & Tavecchio (2009)
+//! give them for a region at height z; fr is 12/17 for the BLR
+static void gt09_udens(double z, double R, double U, double fr, double gamma, double delta,
+                       double& comoving, double& cooling) {
+    double beta = std::sqrt((gamma * gamma - 1.) / (gamma * gamma));
+    auto conv = [beta](double mu1, double mu2) {
+        return 2. * std::pow(1. - beta * mu1, 3.) - std::pow(1. - beta * mu2, 3.) -
+               std::pow(1. - beta, 3.);
+    };
+    if (z < R) {
+        comoving = delta * delta * U;
+        cooling = gamma * gamma * U;
+    } else if (z < 3. * R) {
+        double c = conv(std::pow(10. / 9., -0.5), std::pow(8. / 9., 0.5));
+        double boost = delta * delta * U;
+        comoving = boost + (z - R) / (2. * R) * (boost * c / (3. * beta) - boost);
+        cooling = gamma * gamma * comoving * std::pow(gamma / delta, 2.);
+    } else {
+        double c = conv(std::pow(1. + std::pow(R / z, 2.), -0.5),
+                        std::pow(1. - std::pow(R / z, 2.), 0.5));
+        comoving = delta * delta * U * c / (3. * beta);
+        cooling = gamma * gamma * fr * U * c / (3. * beta);
+    }
+}
+
+TEST_CASE("External photon fields") {
+    SUBCASE("Boost table") {
+        const kariba::ExternalBoostTable& table = kariba::external_boost_table();
+        gsl_interp_accel* acc_z = gsl_interp_accel_alloc();
+        gsl_interp_accel* acc_g = gsl_interp_accel_alloc();
+        CHECK(!table.contains(2., 10.));
+        CHECK(!table.contains(10., 1.));
+        for (double zeta : {3., 4.1, 30., 777., 5e4}) {
+            for (double gamma : {1.05, 2.3, 10., 47., 250.}) {
+                REQUIRE(table.contains(zeta, gamma));
+                CAPTURE(zeta);
+                CAPTURE(gamma);
+                CHECK(table.eval(zeta, gamma, acc_z, acc_g) ==
+                      doctest::Approx(kariba::external_boost(zeta, gamma)).epsilon(2e-3));
+            }
+        }
+        CHECK(kariba::external_boost(0.5, 10.) == 1.);
+        gsl_interp_accel_free(acc_z);
+        gsl_interp_accel_free(acc_g);
+    }
+
+    SUBCASE("BLR and torus") {
+        double lum = 3e45, fblr = 0.1, fdt = 0.3;
+        kariba::ExternalField field;
+        field.add_blr(lum, fblr);
+        field.add_torus(lum, fdt);
+        const std::vector<kariba::ExternalField::Source>& sources = field.get_sources();
+        REQUIRE(sources.size() == 2);
+        double rblr = 1e17 * std::sqrt(lum / 1e45), rdt = 2.5e18 * std::sqrt(lum / 1e45);
+        double ublr = 17. / 12. * fblr * lum / (4. * karcst::pi * rblr * rblr * karcst::cee);
+        double udt = fdt * lum / (4. * karcst::pi * rdt * rdt * karcst::cee);
+        CHECK(sources[0].radius == doctest::Approx(rblr));
+        CHECK(sources[0].udens == doctest::Approx(ublr));
+        CHECK(sources[0].lum == doctest::Approx(fblr * lum));
+        CHECK(sources[1].radius == doctest::Approx(rdt));
+        CHECK(sources[1].udens == doctest::Approx(udt));
+        CHECK(sources[1].temp == 370.);
+
+        gsl_interp_accel* acc_z = gsl_interp_accel_alloc();
+        gsl_interp_accel* acc_g = gsl_interp_accel_alloc();
+        double theta = 3. * karcst::pi / 180.;
+        for (double gamma : {1.5, 8., 30.}) {
+            double beta = std::sqrt((gamma * gamma - 1.) / (gamma * gamma));
+            double delta = 1. / (gamma * (1. - beta * std::cos(theta)));
+            for (double z : {0.3 * rblr, 1.7 * rblr, 12. * rblr, 1.4 * rdt, 40. * rdt, 1e6 * rdt}) {
+                double blr, blr_cool, dt, dt_cool;
+                gt09_udens(z, rblr, ublr, 12. / 17., gamma, delta, blr, blr_cool);
+                gt09_udens(z, rdt, udt, 1., gamma, delta, dt, dt_cool);
+                CAPTURE(gamma);
+                CAPTURE(z);
+                CHECK(field.comoving_udens(0, z, gamma, delta, acc_z, acc_g) ==
+                      doctest::Approx(blr).epsilon(2e-3));
+                CHECK(field.comoving_udens(1, z, gamma, delta, acc_z, acc_g) ==
+                      doctest::Approx(dt).epsilon(2e-3));
+                CHECK(field.cooling_udens(z, gamma, delta, acc_z, acc_g) ==
+                      doctest::Approx(blr_cool + dt_cool).epsilon(2e-3));
+            }
+        }
+        gsl_interp_accel_free(acc_z);
+        gsl_interp_accel_free(acc_g);
+    }
+
+    SUBCASE("Stratified BLR") {
+        double lum = 1e46, f = 0.1;
+        kariba::ExternalField single, one_shell, stratified;
+        single.add_blr(lum, f);
+        one_shell.add_stratified_blr(lum, f, 1, 1., 1.);
+        stratified.add_stratified_blr(lum, f, 4, 0.5, 2.);
+        REQUIRE(stratified.get_sources().size() == 4);
+        CHECK(one_shell.get_sources()[0].radius == single.get_sources()[0].radius);
+        CHECK(one_shell.get_sources()[0].udens == single.get_sources()[0].udens);
+        double total = 0.;
+        for (const kariba::ExternalField::Source& shell : stratified.get_sources()) {
+            total += shell.lum;
+        }
+        CHECK(total == doctest::Approx(single.get_sources()[0].lum));
+        CHECK(stratified.get_sources()[0].radius ==
+              doctest::Approx(0.5 * single.get_sources()[0].radius));
+        CHECK(stratified.get_sources()[3].radius ==
+              doctest::Approx(2. * single.get_sources()[0].radius));
+    }
+}
+
 TEST_CASE("Synchrotron radiation") {
     SUBCASE("Cyclosyn synchrotron emission") {
         kariba::Cyclosyn syncro(100);